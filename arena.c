@@ -0,0 +1,160 @@
+// Sudoku Master Arena
+//
+// Author: Matthew Knight
+// File Name: arena.c
+// Date: 2026-10-14
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "sudoku.h"
+
+void arena_init(struct arena* arena)
+{
+	memset(arena, 0, sizeof(*arena));
+}
+
+void arena_free(struct arena* arena)
+{
+	size_t i;
+
+	for (i = 0; i < arena->chunks_len; ++i)
+		free(arena->chunks[i]);
+
+	free(arena->chunks);
+	arena_init(arena);
+}
+
+int arena_grow(struct arena* arena)
+{
+	size_t cap;
+	uint64_t** chunks;
+	uint64_t* chunk;
+
+	if (arena->chunks_len == arena->chunks_cap) {
+		cap = arena->chunks_cap ? arena->chunks_cap * 2 : 16;
+		chunks = realloc(arena->chunks, cap * sizeof(*chunks));
+		if (!chunks)
+			return -ENOMEM;
+
+		arena->chunks = chunks;
+		arena->chunks_cap = cap;
+	}
+
+	chunk = aligned_alloc(CACHE_LINE_SIZE, ARENA_CHUNK * sizeof(uint64_t));
+	if (!chunk)
+		return -ENOMEM;
+
+	arena->chunks[arena->chunks_len++] = chunk;
+	return 0;
+}
+
+static size_t chunk_len(const struct arena* arena, size_t i)
+{
+	size_t n = arena->len - (i * ARENA_CHUNK);
+
+	return n > ARENA_CHUNK ? ARENA_CHUNK : n;
+}
+
+static inline uint64_t* chunk_at(uint64_t* const* chunks, size_t i)
+{
+	return &chunks[i / ARENA_CHUNK][i % ARENA_CHUNK];
+}
+
+// the same lsd radix sort as samples_sort, passing back and forth between
+// samples and the arenas' chunks rather than a scratch buffer of its own
+static void chunks_sort(struct samples* samples, uint64_t* const* chunks,
+	size_t* counts)
+{
+	int shift;
+	bool chunked = false;
+	size_t i, sum, count, len = samples->len;
+	uint64_t* data = samples->data;
+	uint64_t first;
+
+	for (shift = 0; shift < 64; shift += RADIX_BITS) {
+		memset(counts, 0, sizeof(size_t) * RADIX_SIZE);
+		if (chunked)
+			for (i = 0; i < len; ++i)
+				counts[RADIX_DIGIT(*chunk_at(chunks, i),
+					shift)]++;
+		else
+			for (i = 0; i < len; ++i)
+				counts[RADIX_DIGIT(data[i], shift)]++;
+
+		first = chunked ? *chunk_at(chunks, 0) : data[0];
+		if (counts[RADIX_DIGIT(first, shift)] == len)
+			continue;
+
+		for (i = 0, sum = 0; i < RADIX_SIZE; ++i) {
+			count = counts[i];
+			counts[i] = sum;
+			sum += count;
+		}
+
+		if (chunked)
+			for (i = 0; i < len; ++i) {
+				first = *chunk_at(chunks, i);
+				data[counts[RADIX_DIGIT(first, shift)]++]
+					= first;
+			}
+		else
+			for (i = 0; i < len; ++i)
+				*chunk_at(chunks, counts[RADIX_DIGIT(data[i],
+					shift)]++) = data[i];
+
+		chunked = !chunked;
+	}
+
+	for (i = 0; chunked && i < len; i += ARENA_CHUNK)
+		memcpy(&data[i], chunks[i / ARENA_CHUNK], sizeof(uint64_t)
+			* (len - i < ARENA_CHUNK ? len - i : ARENA_CHUNK));
+}
+
+// copies every arena's samples into samples, which must be empty and have
+// room for them all, and sorts them with the arenas' own chunks as scratch,
+// since between them they have room for every sample. so no scratch the size
+// of the whole run is ever allocated, and the arenas are left clobbered
+int arena_merge(struct arena* const* arenas, size_t len,
+	struct samples* samples)
+{
+	size_t a, i, n, total = 0, chunks_len = 0;
+	uint64_t** chunks;
+	size_t* counts;
+
+	for (a = 0; a < len; ++a) {
+		total += arenas[a]->len;
+		chunks_len += arenas[a]->chunks_len;
+	}
+
+	if (samples->len != 0 || samples->cap < total)
+		return -ERANGE;
+
+	chunks = malloc(sizeof(*chunks) * (chunks_len + 1));
+	counts = malloc(sizeof(size_t) * RADIX_SIZE);
+	if (!chunks || !counts) {
+		free(chunks);
+		free(counts);
+		return -ENOMEM;
+	}
+
+	for (a = 0, chunks_len = 0; a < len; ++a) {
+		for (i = 0; i < arenas[a]->chunks_len; ++i) {
+			n = chunk_len(arenas[a], i);
+			memcpy(&samples->data[samples->len],
+				arenas[a]->chunks[i], n * sizeof(uint64_t));
+			samples->len += n;
+			chunks[chunks_len++] = arenas[a]->chunks[i];
+		}
+	}
+
+	if (samples->len > 1)
+		chunks_sort(samples, chunks, counts);
+
+	free(chunks);
+	free(counts);
+	return 0;
+}
@@ -0,0 +1,58 @@
+// Sudoku Master Arena
+//
+// Author: Matthew Knight
+// File Name: arena.h
+// Date: 2026-10-14
+//
+// An append only store for samples that grows a fixed size chunk at a time, so
+// a worker never needs one huge allocation, and nothing is ever moved once
+// written. Chunks are cache line aligned and allocated by the thread that
+// first appends into them, which places them on that thread's node.
+//
+// The arenas only spare the workers and the sort. At the end of a run they are
+// copied into the module's samples, which are still one contiguous buffer of
+// a sample per puzzle, as the summary and the shard reports read them that
+// way, and sorted with the arenas' chunks as the scratch. A 100M puzzle run so
+// still takes an 800 MB allocation per module for that buffer, though no
+// longer a second one for the sort.
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "stats.h"
+
+// samples per chunk, 512 KiB
+#define ARENA_CHUNK (1 << 16)
+
+struct arena {
+    uint64_t** chunks;
+    size_t chunks_len;
+    size_t chunks_cap;
+    size_t len;
+};
+
+void arena_init(struct arena* arena);
+void arena_free(struct arena* arena);
+int arena_grow(struct arena* arena);
+int arena_merge(struct arena* const* arenas, size_t len,
+	struct samples* samples);
+
+static inline int arena_append(struct arena* arena, uint64_t val)
+{
+	int status;
+
+	if (arena->len == arena->chunks_len * ARENA_CHUNK) {
+		status = arena_grow(arena);
+		if (status < 0)
+			return status;
+	}
+
+	arena->chunks[arena->len / ARENA_CHUNK][arena->len % ARENA_CHUNK] = val;
+	++arena->len;
+	return 0;
+}
+
+#endif
@@ -0,0 +1,580 @@
+// Sudoku Master Self Benchmark
+//
+// Author: Matthew Knight
+// File Name: bench.c
+// Date: 2026-10-14
+//
+// Times the harness's own stages rather than a module: loading a corpus,
+// verifying solutions, reading each clock and aggregating samples, each as the
+// best of several rounds, and the solve of a module that does nothing, whose
+// median and spread, each the median of its rounds, are the floor every other
+// sample sits on. The results are compared against a baseline file, written on
+// the first run, and any stage slower than the baseline by more than the
+// threshold fails the run.
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "corpus.h"
+#include "module.h"
+#include "random.h"
+#include "runner.h"
+#include "stats.h"
+#include "sudoku.h"
+#include "timing.h"
+
+#define BENCH_PUZZLES (1 << 16)
+#define BENCH_SAMPLES (1 << 20)
+#define BENCH_READS (1 << 18)
+#define BENCH_SOLVES (1 << 12)
+#define BENCH_ROUNDS 15
+
+// in percent. a time in nanoseconds also has to move by more than the slack,
+// as a few nanoseconds either way is no more than jitter at the floor
+#define BENCH_RATE_THRESHOLD 50
+#define BENCH_NOISE_THRESHOLD 100
+#define BENCH_NOISE_SLACK_NS 25
+
+#define BENCH_METRICS 16
+
+// the finest clock there is, so that the floor is more than a tick or two
+#ifdef HAVE_TSC
+#define BENCH_CLOCK "tsc"
+#else
+#define BENCH_CLOCK "monotonic-raw"
+#endif
+
+static const char puzzle[] =
+	"..3.2.6..9..3.5..1..18.64....81.29..7.......8..67.82...."
+	"26.95..8..2.3..9..5.1.3..";
+static const char solution[] =
+	"483921657967345821251876493548132976729564138136798245"
+	"372689514814253769695417382";
+
+static const char* clock_names[] = {
+	"process",
+	"thread",
+	"monotonic-raw",
+	"tsc",
+};
+
+// rates are per second and regress by falling, times are in nanoseconds and
+// regress by rising
+struct metric {
+    char name[32];
+    const char* unit;
+    bool rate;
+    double value;
+    double baseline;
+    bool known;
+};
+
+struct bench {
+    struct metric metrics[BENCH_METRICS];
+    size_t len;
+};
+
+// what every round of the stages works on, and the best time each has taken
+// so far. the floor keeps its statistics from every round, to take the median
+// of, since a single preemption moves the stdev and p99 of a round several
+// times over
+struct fixture {
+    FILE* file;
+    uint8_t* grids;
+    uint64_t* values;
+    struct samples samples;
+    struct rng rng;
+    struct module module;
+    struct clock_source clock;
+    struct clock_source clocks[ARRAY_SIZE(clock_names)];
+    bool clocks_ok[ARRAY_SIZE(clock_names)];
+    struct {
+        uint64_t load;
+        uint64_t validate;
+        uint64_t clocks[ARRAY_SIZE(clock_names)];
+        uint64_t stats;
+    } best;
+    struct {
+        double medians[BENCH_ROUNDS];
+        double stdevs[BENCH_ROUNDS];
+        double p99s[BENCH_ROUNDS];
+    } floor;
+};
+
+static const struct option options[] = {
+	{ "clock", required_argument, NULL, 'c' },
+	{ "rate", required_argument, NULL, 't' },
+	{ "noise", required_argument, NULL, 'n' },
+	{ "update", no_argument, NULL, 'u' },
+	{ "help", no_argument, NULL, 'h' },
+	{ NULL, 0, NULL, 0 }
+};
+
+void bench_add(struct bench* bench, const char* name,
+	const char* unit, bool rate, double value)
+{
+	struct metric* metric = &bench->metrics[bench->len++];
+
+	snprintf(metric->name, sizeof(metric->name), "%s", name);
+	metric->unit = unit;
+	metric->rate = rate;
+	metric->value = value;
+}
+
+void grid_parse(uint8_t* grid, const char* src)
+{
+	int i;
+
+	for (i = 0; i < SUDOKU_SIZE; ++i)
+		grid[i] = src[i] == '.' ? 0 : src[i] - '0';
+}
+
+static int compare_doubles(const void* a, const void* b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
+
+static double median_of(double* vals, size_t len)
+{
+	qsort(vals, len, sizeof(double), compare_doubles);
+	return vals[len / 2];
+}
+
+static void keep_best(uint64_t* best, uint64_t start)
+{
+	uint64_t elapsed = monotonic_ns() - start;
+
+	if (elapsed < *best)
+		*best = elapsed;
+}
+
+// the corpus is written to a temporary file one puzzle per line, so that it's
+// memory mapped like a corpus redirected from disk. the solutions are
+// verified without an expected one, so every grid is checked in full, and the
+// clocks that aren't available here are left out, and so never compared
+int fixture_init(struct fixture* fixture, const char* filename,
+	const char* clock_name)
+{
+	int status, i;
+	size_t n;
+
+	memset(fixture, 0, sizeof(*fixture));
+	fixture->best.load = fixture->best.validate = UINT64_MAX;
+	fixture->best.stats = UINT64_MAX;
+	for (i = 0; i < ARRAY_SIZE(clock_names); ++i)
+		fixture->best.clocks[i] = UINT64_MAX;
+
+	status = clock_source_init(&fixture->clock, clock_name);
+	if (status < 0)
+		return status;
+
+	for (i = 0; i < ARRAY_SIZE(clock_names); ++i)
+		fixture->clocks_ok[i] = clock_source_init(&fixture->clocks[i],
+			clock_names[i]) == 0;
+
+	fixture->file = tmpfile();
+	if (!fixture->file) {
+		perror("failed to create corpus file");
+		return -errno;
+	}
+
+	for (n = 0; n < BENCH_PUZZLES; ++n)
+		fprintf(fixture->file, "%s\n", puzzle);
+
+	if (fflush(fixture->file) != 0) {
+		perror("failed to write corpus file");
+		return -errno;
+	}
+
+	fixture->grids = malloc(2 * SUDOKU_SIZE * BENCH_PUZZLES);
+	fixture->values = malloc(sizeof(uint64_t) * BENCH_SAMPLES);
+	fixture->samples.data = malloc(sizeof(uint64_t) * BENCH_SAMPLES);
+	fixture->samples.cap = BENCH_SAMPLES;
+	if (!fixture->grids || !fixture->values || !fixture->samples.data) {
+		fputs("failed to allocate fixtures\n", stderr);
+		return -ENOMEM;
+	}
+
+	for (n = 0; n < BENCH_PUZZLES; ++n) {
+		grid_parse(&fixture->grids[2 * SUDOKU_SIZE * n], puzzle);
+		grid_parse(&fixture->grids[(2 * n + 1) * SUDOKU_SIZE],
+			solution);
+	}
+
+	rng_seed(&fixture->rng, 0, 0);
+	for (n = 0; n < BENCH_SAMPLES; ++n)
+		fixture->values[n] = 1000 + rng_below(&fixture->rng, 100000);
+
+	status = module_init(&fixture->module, filename);
+	if (status < 0) {
+		fprintf(stderr, "failed to load module: %s\n", filename);
+		return status;
+	}
+
+	return 0;
+}
+
+void fixture_free(struct fixture* fixture)
+{
+	if (fixture->file)
+		fclose(fixture->file);
+
+	free(fixture->grids);
+	free(fixture->values);
+	free(fixture->samples.data);
+}
+
+int bench_load(struct fixture* fixture)
+{
+	int status;
+	uint64_t start;
+	struct corpus corpus;
+
+	start = monotonic_ns();
+	status = corpus_load(&corpus, fileno(fixture->file));
+	if (status < 0)
+		return status;
+
+	keep_best(&fixture->best.load, start);
+	corpus_free(&corpus);
+	return 0;
+}
+
+int bench_validate(struct fixture* fixture)
+{
+	size_t i;
+	uint64_t start;
+	const uint8_t* grids = fixture->grids;
+	volatile int failed = 0;
+
+	start = monotonic_ns();
+	for (i = 0; i < BENCH_PUZZLES; ++i)
+		failed += verify(&grids[2 * SUDOKU_SIZE * i], NULL,
+			&grids[(2 * i + 1) * SUDOKU_SIZE]) < 0;
+	keep_best(&fixture->best.validate, start);
+
+	if (failed) {
+		fputs("benchmark solution failed to verify\n", stderr);
+		return -1;
+	}
+
+	return 0;
+}
+
+void bench_clocks(struct fixture* fixture)
+{
+	int i, k;
+	uint64_t start;
+	volatile uint64_t sink;
+
+	for (i = 0; i < ARRAY_SIZE(clock_names); ++i) {
+		if (!fixture->clocks_ok[i])
+			continue;
+
+		start = monotonic_ns();
+		for (k = 0; k < BENCH_READS; ++k)
+			sink = clock_read(&fixture->clocks[i]);
+		keep_best(&fixture->best.clocks[i], start);
+	}
+
+	(void)sink;
+}
+
+// the samples go through the same arena, copy, sort and summary as a
+// module's do at the end of a run
+int bench_stats(struct fixture* fixture)
+{
+	int status = 0;
+	size_t i;
+	uint64_t start;
+	struct arena arena;
+	struct arena* arenas = &arena;
+	struct summary summary;
+
+	arena_init(&arena);
+	fixture->samples.len = 0;
+
+	start = monotonic_ns();
+	for (i = 0; i < BENCH_SAMPLES && status == 0; ++i)
+		status = arena_append(&arena, fixture->values[i]);
+	if (status == 0)
+		status = arena_merge(&arenas, 1, &fixture->samples);
+	summary_compute(&summary, &fixture->samples);
+	keep_best(&fixture->best.stats, start);
+
+	arena_free(&arena);
+	if (status < 0) {
+		fputs("failed to aggregate samples\n", stderr);
+		return status;
+	}
+
+	return 0;
+}
+
+// the module is timed exactly as a module under test is, with the solution
+// left unchecked as a null module never fills one in
+int bench_floor(struct fixture* fixture, int round)
+{
+	int status = 0;
+	size_t i;
+	uint64_t duration;
+	int scratch[SUDOKU_SIZE];
+	uint8_t grid[SUDOKU_SIZE], output[SUDOKU_SIZE];
+	const struct clock_source* clock = &fixture->clock;
+	struct samples* samples = &fixture->samples;
+	struct summary summary;
+
+	grid_parse(grid, puzzle);
+	samples->len = 0;
+	for (i = 0; i < BENCH_SOLVES && status == 0; ++i) {
+		if (solve_in(&fixture->module, grid, clock, NULL, NULL,
+			scratch, output, &duration) != OUTCOME_SOLVED) {
+			fputs("null module failed to solve\n", stderr);
+			return -1;
+		}
+
+		status = samples_append(samples, duration);
+	}
+
+	if (status == 0)
+		status = samples_sort(samples);
+	if (status < 0)
+		return status;
+
+	summary_compute(&summary, samples);
+	fixture->floor.medians[round] = clock_to_ns_f(clock, summary.median);
+	fixture->floor.stdevs[round] = clock_to_ns_f(clock, summary.stdev);
+	fixture->floor.p99s[round] = clock_to_ns_f(clock, summary.p99);
+	return 0;
+}
+
+// every round runs each stage once, so that a stretch of noise from the rest
+// of the machine costs one round of every stage, not every round of one
+int bench_run(struct bench* bench, struct fixture* fixture)
+{
+	int status, r, i;
+	char name[32];
+
+	for (r = 0; r < BENCH_ROUNDS; ++r) {
+		status = bench_load(fixture);
+		if (status == 0)
+			status = bench_validate(fixture);
+		if (status == 0) {
+			bench_clocks(fixture);
+			status = bench_stats(fixture);
+		}
+		if (status == 0)
+			status = bench_floor(fixture, r);
+		if (status < 0)
+			return status;
+	}
+
+	bench_add(bench, "load", "puzzles/s", true,
+		(BENCH_PUZZLES * 1e9) / fixture->best.load);
+	bench_add(bench, "validate", "puzzles/s", true,
+		(BENCH_PUZZLES * 1e9) / fixture->best.validate);
+	for (i = 0; i < ARRAY_SIZE(clock_names); ++i) {
+		if (!fixture->clocks_ok[i])
+			continue;
+
+		snprintf(name, sizeof(name), "clock_%s", clock_names[i]);
+		bench_add(bench, name, "reads/s", true,
+			(BENCH_READS * 1e9) / fixture->best.clocks[i]);
+	}
+
+	bench_add(bench, "stats", "samples/s", true,
+		(BENCH_SAMPLES * 1e9) / fixture->best.stats);
+	bench_add(bench, "floor_median", "ns", false,
+		median_of(fixture->floor.medians, BENCH_ROUNDS));
+	bench_add(bench, "floor_stdev", "ns", false,
+		median_of(fixture->floor.stdevs, BENCH_ROUNDS));
+	bench_add(bench, "floor_p99", "ns", false,
+		median_of(fixture->floor.p99s, BENCH_ROUNDS));
+	return 0;
+}
+
+// a missing baseline isn't an error, it's written at the end of the run
+int baseline_read(struct bench* bench, const char* filename)
+{
+	char line[128], name[32];
+	double value;
+	size_t i;
+	FILE* file = fopen(filename, "r");
+
+	if (!file) {
+		if (errno == ENOENT)
+			return 0;
+
+		fprintf(stderr, "failed to open baseline %s: %s\n", filename,
+			strerror(errno));
+		return -errno;
+	}
+
+	while (fgets(line, sizeof(line), file)) {
+		if (line[0] == '#' || sscanf(line, "%31s %lf", name, &value)
+			!= 2)
+			continue;
+
+		for (i = 0; i < bench->len; ++i) {
+			if (strcmp(bench->metrics[i].name, name) != 0)
+				continue;
+
+			bench->metrics[i].baseline = value;
+			bench->metrics[i].known = true;
+		}
+	}
+
+	fclose(file);
+	return 0;
+}
+
+int baseline_write(const struct bench* bench, const char* filename)
+{
+	size_t i;
+	FILE* file = fopen(filename, "w");
+
+	if (!file) {
+		fprintf(stderr, "failed to open baseline %s: %s\n", filename,
+			strerror(errno));
+		return -errno;
+	}
+
+	fputs("# sudoku-bench baseline: stage value\n", file);
+	for (i = 0; i < bench->len; ++i)
+		fprintf(file, "%s %.1f\n", bench->metrics[i].name,
+			bench->metrics[i].value);
+
+	if (fclose(file) != 0) {
+		fprintf(stderr, "failed to write baseline %s: %s\n", filename,
+			strerror(errno));
+		return -errno;
+	}
+
+	return 0;
+}
+
+bool regressed(const struct metric* metric, double rate, double noise)
+{
+	if (!metric->known)
+		return false;
+
+	if (metric->rate)
+		return metric->value
+			< metric->baseline * (1 - (rate / 100));
+
+	return metric->value > metric->baseline * (1 + (noise / 100))
+		&& metric->value - metric->baseline > BENCH_NOISE_SLACK_NS;
+}
+
+void usage(const char* prog)
+{
+	fprintf(stderr,
+		"usage: %s [options] <null module> <baseline>\n"
+		"\n"
+		"  -c, --clock NAME time the null module against NAME\n"
+		"                   (default: " BENCH_CLOCK ")\n"
+		"  -t, --rate PCT   fail when a stage's rate falls more than\n"
+		"                   PCT percent (default: 50)\n"
+		"  -n, --noise PCT  fail when a floor time rises more than\n"
+		"                   PCT percent (default: 100)\n"
+		"  -u, --update     write the results as the new baseline\n"
+		"  -h, --help       print this message\n",
+		prog);
+}
+
+int main(int argc, char* argv[])
+{
+	int status, opt;
+	size_t i, rate = BENCH_RATE_THRESHOLD, noise = BENCH_NOISE_THRESHOLD;
+	size_t failed = 0;
+	bool update = false, known = false;
+	const char* clock_name = BENCH_CLOCK;
+	const char* baseline;
+	struct fixture fixture;
+	struct bench bench = { .len = 0 };
+
+	while ((opt = getopt_long(argc, argv, "c:t:n:uh", options, NULL))
+		!= -1) {
+		switch (opt) {
+		case 'c':
+			clock_name = optarg;
+			break;
+		case 't':
+			rate = strtoul(optarg, NULL, 10);
+			break;
+		case 'n':
+			noise = strtoul(optarg, NULL, 10);
+			break;
+		case 'u':
+			update = true;
+			break;
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+
+	if (argc - optind != 2) {
+		usage(argv[0]);
+		return -1;
+	}
+
+	baseline = argv[optind + 1];
+	status = fixture_init(&fixture, argv[optind], clock_name);
+	if (status == 0)
+		status = bench_run(&bench, &fixture);
+
+	fixture_free(&fixture);
+	if (status < 0)
+		return status;
+
+	status = baseline_read(&bench, baseline);
+	if (status < 0)
+		return status;
+
+	printf("# clock: %s\n", fixture.clock.name);
+	printf("stage,unit,value,baseline,change\n");
+	for (i = 0; i < bench.len; ++i) {
+		const struct metric* metric = &bench.metrics[i];
+
+		printf("%s,%s,%.1f", metric->name, metric->unit,
+			metric->value);
+		if (metric->known && metric->baseline > 0)
+			printf(",%.1f,%+.1f%%", metric->baseline,
+				((metric->value / metric->baseline) - 1) * 100);
+		else
+			printf(",,");
+
+		putchar('\n');
+		known |= metric->known;
+	}
+
+	for (i = 0; i < bench.len; ++i) {
+		if (!regressed(&bench.metrics[i], rate, noise))
+			continue;
+
+		fprintf(stderr, "regressed: %s\n", bench.metrics[i].name);
+		++failed;
+	}
+
+	if (update || !known) {
+		status = baseline_write(&bench, baseline);
+		if (status < 0)
+			return status;
+
+		fprintf(stderr, "wrote baseline %s\n", baseline);
+		return 0;
+	}
+
+	return failed > 0 ? 1 : 0;
+}
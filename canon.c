@@ -0,0 +1,381 @@
+// Sudoku Master Canonicalizer
+//
+// Author: Matthew Knight
+// File Name: canon.c
+// Date: 2026-10-14
+//
+// The canonical form is built a row at a time. A candidate is a transposition,
+// one of the 1296 column orders, and the rows picked so far along with the
+// digit labels handed out so far, in order of first appearance. Each round
+// extends every candidate by each row the band structure still allows, and
+// only the candidates that produced the smallest row survive to the next one.
+// Most puzzles are down to a handful of candidates after the first few rows.
+
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "canon.h"
+#include "tables.h"
+
+#define CANON_COLUMN_ORDERS 1296
+#define CANON_TABLE_EMPTY SIZE_MAX
+
+struct candidate {
+    uint8_t transposed;
+    uint8_t band;
+    uint16_t order;
+    uint16_t rows;
+    uint8_t labels[SUDOKU_AXIS_SIZE + 1];
+    uint8_t next;
+};
+
+struct candidates {
+    struct candidate* data;
+    size_t len;
+    size_t cap;
+};
+
+static const uint8_t perms[6][3] = {
+	{ 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 },
+	{ 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 },
+};
+
+// perms as constant expressions, for the order table
+#define PERM(p) ((p) == 0 ? 0x012 : (p) == 1 ? 0x021 : (p) == 2 ? 0x102 \
+	: (p) == 3 ? 0x120 : (p) == 4 ? 0x201 : 0x210)
+#define PERM_AT(p, k) ((PERM(p) >> (4 * (2 - (k)))) & 0xf)
+
+// an order is a stack permutation followed by one permutation within each
+// stack, in base 6
+#define ORDER_COL(o, k) ((3 * PERM_AT((o) / 216, (k) / 3)) \
+	+ PERM_AT(((o) / (36 / ((k) / 3 == 0 ? 1 : (k) / 3 == 1 ? 6 : 36))) \
+		% 6, (k) % 3))
+
+#define ORDER(o) { \
+	ORDER_COL(o, 0), ORDER_COL(o, 1), ORDER_COL(o, 2), \
+	ORDER_COL(o, 3), ORDER_COL(o, 4), ORDER_COL(o, 5), \
+	ORDER_COL(o, 6), ORDER_COL(o, 7), ORDER_COL(o, 8) }
+
+#define ORDERS6(o) ORDER(o), ORDER((o) + 1), ORDER((o) + 2), \
+	ORDER((o) + 3), ORDER((o) + 4), ORDER((o) + 5)
+#define ORDERS36(o) ORDERS6(o), ORDERS6((o) + 6), ORDERS6((o) + 12), \
+	ORDERS6((o) + 18), ORDERS6((o) + 24), ORDERS6((o) + 30)
+#define ORDERS216(o) ORDERS36(o), ORDERS36((o) + 36), ORDERS36((o) + 72), \
+	ORDERS36((o) + 108), ORDERS36((o) + 144), ORDERS36((o) + 180)
+
+static const uint8_t orders[CANON_COLUMN_ORDERS][SUDOKU_AXIS_SIZE] = {
+	ORDERS216(0), ORDERS216(216), ORDERS216(432),
+	ORDERS216(648), ORDERS216(864), ORDERS216(1080),
+};
+
+struct entry {
+    uint64_t hash;
+    size_t index;
+};
+
+static int candidates_push(struct candidates* c, const struct candidate* cand)
+{
+	size_t cap;
+	struct candidate* data;
+
+	if (c->len == c->cap) {
+		cap = c->cap ? c->cap * 2 : 4096;
+		data = realloc(c->data, cap * sizeof(*data));
+		if (!data)
+			return -ENOMEM;
+
+		c->data = data;
+		c->cap = cap;
+	}
+
+	c->data[c->len++] = *cand;
+	return 0;
+}
+
+// a 3 bit mask of the givens of one stack of a row, by column
+static unsigned canon_stack(const uint8_t* grid, int row, int stack)
+{
+	int k;
+	unsigned mask = 0;
+
+	for (k = 0; k < 3; ++k)
+		if (grid[(row * 9) + (3 * stack) + k])
+			mask |= 1u << k;
+
+	return mask;
+}
+
+// the stack masks, pushed right, in ascending order
+static unsigned canon_bound(uint8_t* m)
+{
+	uint8_t tmp;
+
+	if (m[0] > m[1]) { tmp = m[0]; m[0] = m[1]; m[1] = tmp; }
+	if (m[1] > m[2]) { tmp = m[1]; m[1] = m[2]; m[2] = tmp; }
+	if (m[0] > m[1]) { tmp = m[0]; m[0] = m[1]; m[1] = tmp; }
+
+	return (m[0] << 6) | (m[1] << 3) | m[2];
+}
+
+// the digits of the first row are always labelled 1, 2, 3... from left to
+// right, so all that matters is where its givens end up, and the fewer of them
+// and the further right, the smaller the row. the row is reduced to a mask of
+// its givens, first position in the highest bit, and every order is scored by
+// permuting the mask a stack at a time
+static int canon_first_row(const uint8_t grids[2][SUDOKU_SIZE],
+	struct candidates* current, uint8_t* canonical)
+{
+	int status, t, source, order, s, p, k, m;
+	unsigned mask, best = UINT_MAX;
+	uint8_t inner[6][8], stacks[3], counts[3], v;
+	unsigned bounds[2][SUDOKU_AXIS_SIZE];
+	uint16_t scores[CANON_COLUMN_ORDERS];
+	struct candidate cand;
+
+	for (p = 0; p < 6; ++p) {
+		for (m = 0; m < 8; ++m) {
+			inner[p][m] = 0;
+			for (k = 0; k < 3; ++k)
+				inner[p][m] |= ((m >> perms[p][k]) & 1)
+					<< (2 - k);
+		}
+	}
+
+	// a row's best score is its stacks sorted by how many givens they hold,
+	// each with its givens pushed right, so only the rows that can reach
+	// the smallest score need their orders scored
+	for (t = 0; t < 2; ++t) {
+		for (source = 0; source < SUDOKU_AXIS_SIZE; ++source) {
+			for (s = 0; s < 3; ++s)
+				counts[s] = (1u << __builtin_popcount(
+					canon_stack(grids[t], source, s))) - 1;
+
+			bounds[t][source] = canon_bound(counts);
+			if (bounds[t][source] < best)
+				best = bounds[t][source];
+		}
+	}
+
+	current->len = 0;
+	for (t = 0; t < 2; ++t) {
+		for (source = 0; source < SUDOKU_AXIS_SIZE; ++source) {
+			if (bounds[t][source] != best)
+				continue;
+
+			for (s = 0; s < 3; ++s)
+				stacks[s] = canon_stack(grids[t], source, s);
+
+			for (order = 0; order < CANON_COLUMN_ORDERS; ++order) {
+				p = order / 216;
+				mask = (inner[(order / 36) % 6]
+						[stacks[perms[p][0]]] << 6)
+					| (inner[(order / 6) % 6]
+						[stacks[perms[p][1]]] << 3)
+					| inner[order % 6][stacks[perms[p][2]]];
+				scores[order] = mask;
+			}
+
+			for (order = 0; order < CANON_COLUMN_ORDERS; ++order) {
+				if (scores[order] != best)
+					continue;
+
+				memset(&cand, 0, sizeof(cand));
+				cand.transposed = t;
+				cand.order = order;
+				cand.rows = 1u << source;
+				cand.band = source / 3;
+				cand.next = 1;
+				for (k = 0; k < SUDOKU_AXIS_SIZE; ++k) {
+					v = grids[t][(source * 9)
+						+ orders[order][k]];
+					if (v != 0)
+						cand.labels[v] = cand.next++;
+				}
+
+				status = candidates_push(current, &cand);
+				if (status < 0)
+					return status;
+			}
+		}
+	}
+
+	for (k = 0, m = 1; k < SUDOKU_AXIS_SIZE; ++k)
+		canonical[k] = best & (1u << (8 - k)) ? m++ : 0;
+
+	return 0;
+}
+
+int canon_form(const uint8_t* puzzle, uint8_t* canonical)
+{
+	int status = 0, cmp, r, k, source, first, last;
+	unsigned used;
+	size_t i;
+	uint8_t grids[2][SUDOKU_SIZE], row[SUDOKU_AXIS_SIZE], v;
+	uint8_t* least;
+	struct candidate cand, next;
+	struct candidates current = { 0 }, survivors = { 0 }, swap;
+	const uint8_t* src;
+	const uint8_t* order;
+	bool found;
+
+	for (i = 0; i < SUDOKU_SIZE; ++i) {
+		grids[0][i] = puzzle[i];
+		grids[1][i] = puzzle[(cell_units[i].col * 9)
+			+ cell_units[i].row];
+	}
+
+	status = canon_first_row(grids, &current, canonical);
+	if (status < 0)
+		goto out;
+
+	for (r = 1; r < SUDOKU_AXIS_SIZE; ++r) {
+		found = false;
+		survivors.len = 0;
+
+		for (i = 0; i < current.len; ++i) {
+			cand = current.data[i];
+			src = grids[cand.transposed];
+			order = orders[cand.order];
+
+			// a band's first row may come from any band not yet
+			// used, the rest from the same band
+			first = r % 3 == 0 ? 0 : 3 * cand.band;
+			last = r % 3 == 0 ? SUDOKU_AXIS_SIZE : first + 3;
+			least = &canonical[r * 9];
+
+			for (source = first; source < last; ++source) {
+				used = r % 3 == 0 ? 7u << (3 * (source / 3))
+					: 1u << source;
+				if (cand.rows & used)
+					continue;
+
+				next = cand;
+				next.rows |= 1u << source;
+				next.band = source / 3;
+
+				// bail out once the row is known to be larger
+				cmp = found ? 0 : -1;
+				for (k = 0; k < SUDOKU_AXIS_SIZE && cmp <= 0;
+					++k) {
+					v = src[(source * 9) + order[k]];
+					if (v != 0 && next.labels[v] == 0)
+						next.labels[v] = next.next++;
+
+					row[k] = next.labels[v];
+					if (cmp == 0 && row[k] != least[k])
+						cmp = row[k] < least[k]
+							? -1 : 1;
+				}
+
+				if (cmp > 0)
+					continue;
+
+				if (cmp < 0) {
+					memcpy(least, row, SUDOKU_AXIS_SIZE);
+					survivors.len = 0;
+					found = true;
+				}
+
+				status = candidates_push(&survivors, &next);
+				if (status < 0)
+					goto out;
+			}
+		}
+
+		swap = current;
+		current = survivors;
+		survivors = swap;
+	}
+
+	status = 0;
+
+out:
+	free(current.data);
+	free(survivors.data);
+	return status;
+}
+
+// fnv-1a
+uint64_t canon_hash(const uint8_t* canonical)
+{
+	int i;
+	uint64_t hash = 0xcbf29ce484222325;
+
+	for (i = 0; i < SUDOKU_SIZE; ++i) {
+		hash ^= canonical[i];
+		hash *= 0x100000001b3;
+	}
+
+	return hash;
+}
+
+// drops every puzzle equivalent to one before it, keeping the order of the
+// rest. a hash match is only taken as a duplicate once the canonical forms
+// are compared
+int canon_dedup(struct corpus* corpus, size_t* duplicates)
+{
+	int status;
+	size_t n, kept = 0, slots = 1, slot;
+	uint64_t hash;
+	uint8_t canonical[SUDOKU_SIZE], other[SUDOKU_SIZE];
+	struct entry* table;
+
+	while (slots < corpus->len * 2)
+		slots <<= 1;
+
+	table = malloc(slots * sizeof(*table));
+	if (!table) {
+		fputs("failed to allocate canonical table\n", stderr);
+		return -ENOMEM;
+	}
+
+	for (slot = 0; slot < slots; ++slot)
+		table[slot].index = CANON_TABLE_EMPTY;
+
+	for (n = 0; n < corpus->len; ++n) {
+		status = canon_form(corpus_get(corpus, n), canonical);
+		if (status < 0)
+			goto out;
+
+		hash = canon_hash(canonical);
+		for (slot = hash & (slots - 1);
+			table[slot].index != CANON_TABLE_EMPTY;
+			slot = (slot + 1) & (slots - 1)) {
+			if (table[slot].hash != hash)
+				continue;
+
+			status = canon_form(corpus_get(corpus,
+				table[slot].index), other);
+			if (status < 0)
+				goto out;
+
+			if (memcmp(canonical, other, SUDOKU_SIZE) == 0)
+				break;
+		}
+
+		if (table[slot].index != CANON_TABLE_EMPTY)
+			continue;
+
+		if (kept != n)
+			memcpy(corpus_get(corpus, kept), corpus_get(corpus, n),
+				SUDOKU_SIZE);
+
+		table[slot].hash = hash;
+		table[slot].index = kept++;
+	}
+
+	*duplicates = corpus->len - kept;
+	corpus->len = kept;
+	status = 0;
+
+out:
+	if (status < 0)
+		fputs("failed to canonicalize puzzles\n", stderr);
+
+	free(table);
+	return status;
+}
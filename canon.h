@@ -0,0 +1,25 @@
+// Sudoku Master Canonicalizer
+//
+// Author: Matthew Knight
+// File Name: canon.h
+// Date: 2026-10-14
+//
+// Two puzzles are equivalent if one can be turned into the other by
+// relabelling digits, permuting bands, stacks, and the rows and columns within
+// them, and transposing. The canonical form of a puzzle is the
+// lexicographically smallest grid it is equivalent to, so equivalent puzzles
+// share one canonical form and hash.
+
+#ifndef CANON_H
+#define CANON_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "corpus.h"
+
+int canon_form(const uint8_t* puzzle, uint8_t* canonical);
+uint64_t canon_hash(const uint8_t* canonical);
+int canon_dedup(struct corpus* corpus, size_t* duplicates);
+
+#endif
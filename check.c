@@ -0,0 +1,80 @@
+// Sudoku Master Validator
+//
+// Author: Matthew Knight
+// File Name: check.c
+// Date: 2026-10-14
+//
+// Every cell is turned into a bit, 1 << value, with empty cells contributing
+// nothing, and the bits are then folded over each of the 27 rows, columns and
+// boxes with the static table of their cells (see tables.h). Errors are
+// accumulated rather than branched on, so a valid grid, which is by far the
+// common case, is checked in one straight line pass.
+
+#include <stdbool.h>
+
+#include "check.h"
+
+#define FULL_UNIT 0x3fe
+
+// values above 9 give a bit outside of FULL_UNIT, and zero gives bit 0 which
+// is masked off
+static inline bool grid_bits(uint16_t* bits, const uint8_t* puzzle)
+{
+	int i;
+	unsigned bad = 0;
+
+	for (i = 0; i < SUDOKU_SIZE; ++i) {
+		bad |= puzzle[i] > 9;
+		bits[i] = (1u << (puzzle[i] & 0xf)) & FULL_UNIT;
+	}
+
+	return !bad;
+}
+
+// returns -2 for values that aren't a digit or empty, and -1 for a digit
+// repeated within a row, column or box
+int check(const uint8_t* puzzle)
+{
+	int u, j;
+	uint16_t bits[SUDOKU_SIZE], seen, dup = 0;
+
+	if (!grid_bits(bits, puzzle))
+		return -2;
+
+	for (u = 0; u < SUDOKU_UNITS; ++u) {
+		seen = 0;
+		for (j = 0; j < SUDOKU_AXIS_SIZE; ++j) {
+			uint16_t bit = bits[units[u][j]];
+
+			dup |= seen & bit;
+			seen |= bit;
+		}
+	}
+
+	return dup ? -1 : 0;
+}
+
+// a complete grid is valid exactly when every unit holds all nine digits, so
+// there is no need to look for repeats
+int cross_check(const uint8_t* puzzle, const uint8_t* solution)
+{
+	int u, i, j;
+	unsigned bad = 0;
+	uint16_t bits[SUDOKU_SIZE], seen;
+
+	for (i = 0; i < SUDOKU_SIZE; ++i) {
+		bad |= (uint8_t)(solution[i] - 1) > 8;
+		bad |= puzzle[i] != 0 && puzzle[i] != solution[i];
+		bits[i] = 1u << (solution[i] & 0xf);
+	}
+
+	for (u = 0; u < SUDOKU_UNITS; ++u) {
+		seen = 0;
+		for (j = 0; j < SUDOKU_AXIS_SIZE; ++j)
+			seen |= bits[units[u][j]];
+
+		bad |= seen != FULL_UNIT;
+	}
+
+	return bad ? -1 : 0;
+}
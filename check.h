@@ -0,0 +1,18 @@
+// Sudoku Master Validator
+//
+// Author: Matthew Knight
+// File Name: check.h
+// Date: 2026-10-14
+
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdint.h>
+
+#include "sudoku.h"
+#include "tables.h"
+
+int check(const uint8_t* puzzle);
+int cross_check(const uint8_t* puzzle, const uint8_t* solution);
+
+#endif
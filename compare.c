@@ -0,0 +1,232 @@
+// Sudoku Master Comparison
+//
+// Author: Matthew Knight
+// File Name: compare.c
+// Date: 2026-10-14
+//
+// The confidence interval on the median speedup is a poisson bootstrap over
+// the bins. Weighting every pair by an independent Poisson(1) draw is the same
+// as weighting every bin by a single Poisson(count) draw, so a resample costs
+// one draw per occupied bin rather than one per puzzle. The significance test
+// is a two sided sign test on which module was faster, which assumes nothing
+// about the shape of the durations, and they are far from normal.
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "compare.h"
+
+// below this the sign test is summed exactly
+#define COMPARE_EXACT_PAIRS 1000
+
+// above this a poisson draw is approximated by a normal one
+#define COMPARE_POISSON_NORMAL 30
+
+static double uniform(struct rng* rng)
+{
+	return (rng_next(rng) >> 11) * 0x1p-53;
+}
+
+static double normal(struct rng* rng)
+{
+	double u = 1.0 - uniform(rng), v = uniform(rng);
+
+	return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static uint64_t poisson(struct rng* rng, uint64_t mean)
+{
+	uint64_t k = 0;
+	double limit, p = 1.0, val;
+
+	if (mean > COMPARE_POISSON_NORMAL) {
+		val = mean + sqrt(mean) * normal(rng) + 0.5;
+		return val > 0 ? (uint64_t)val : 0;
+	}
+
+	limit = exp(-(double)mean);
+	for (;;) {
+		p *= uniform(rng);
+		if (p <= limit)
+			return k;
+
+		++k;
+	}
+}
+
+// the bin's midpoint as a log2 ratio
+static double bin_value(size_t i)
+{
+	return (i + 0.5) / COMPARE_BINS_PER_OCTAVE - COMPARE_OCTAVES;
+}
+
+static size_t bin_of(double log_ratio)
+{
+	double i = floor((log_ratio + COMPARE_OCTAVES)
+		* COMPARE_BINS_PER_OCTAVE);
+
+	if (i < 0)
+		return 0;
+	if (i >= COMPARE_BINS)
+		return COMPARE_BINS - 1;
+
+	return i;
+}
+
+// the median of weighted bins, given as indices into them. the values in the
+// median's bin are taken as spread evenly across it, so that the medians of
+// resamples aren't all rounded to the same bin on a large corpus
+static double weighted_median(const size_t* occupied, const uint64_t* weights,
+	size_t len, uint64_t total)
+{
+	size_t i;
+	uint64_t seen = 0;
+	double half = total / 2.0;
+
+	for (i = 0; i < len; ++i) {
+		if (weights[i] > 0 && seen + weights[i] >= half)
+			return bin_value(occupied[i]) + ((half - seen)
+				/ weights[i] - 0.5) / COMPARE_BINS_PER_OCTAVE;
+
+		seen += weights[i];
+	}
+
+	return bin_value(occupied[len - 1]);
+}
+
+static int compare_doubles(const void* a, const void* b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+
+	return (x > y) - (x < y);
+}
+
+// twice the probability of a split at least as uneven as wins to losses, if
+// either module were equally likely to be faster
+static double sign_test(uint64_t wins, uint64_t losses)
+{
+	uint64_t i, n = wins + losses, k = wins < losses ? wins : losses;
+	double p = 0, z;
+
+	if (n == 0)
+		return 1.0;
+
+	if (n <= COMPARE_EXACT_PAIRS) {
+		for (i = 0; i <= k; ++i)
+			p += exp(lgamma(n + 1.0) - lgamma(i + 1.0)
+				- lgamma(n - i + 1.0) - n * M_LN2);
+	} else {
+		z = (k + 0.5 - n / 2.0) / sqrt(n / 4.0);
+		p = 0.5 * erfc(-z / M_SQRT2);
+	}
+
+	return 2 * p < 1.0 ? 2 * p : 1.0;
+}
+
+void comparison_reset(struct comparison* comparison)
+{
+	memset(comparison, 0, sizeof(*comparison));
+}
+
+// a zero duration, which a solve faster than the clock's overhead can have, is
+// taken as a single tick so that the ratio stays finite
+void comparison_add(struct comparison* comparison, uint64_t a, uint64_t b)
+{
+	double log_ratio = log2((double)(b > 0 ? b : 1) / (a > 0 ? a : 1));
+
+	++comparison->bins[bin_of(log_ratio)];
+	moments_add(&comparison->differences, (double)a - (double)b);
+	moments_add(&comparison->logs, log_ratio);
+	if (a < b)
+		++comparison->wins;
+	else if (b < a)
+		++comparison->losses;
+}
+
+int comparison_judge(const struct comparison* comparison, struct rng* rng,
+	struct verdict* verdict)
+{
+	size_t i, len = 0, r, tail;
+	uint64_t total;
+	size_t* occupied;
+	uint64_t *counts, *weights;
+	double* medians;
+
+	memset(verdict, 0, sizeof(*verdict));
+	verdict->pairs = comparison->logs.len;
+	verdict->wins = comparison->wins;
+	verdict->losses = comparison->losses;
+	verdict->p_value = sign_test(comparison->wins, comparison->losses);
+	if (verdict->pairs == 0)
+		return 0;
+
+	verdict->mean_difference = comparison->differences.mean;
+	verdict->geomean = exp2(comparison->logs.mean);
+
+	occupied = malloc(sizeof(size_t) * COMPARE_BINS);
+	counts = malloc(sizeof(uint64_t) * COMPARE_BINS);
+	weights = malloc(sizeof(uint64_t) * COMPARE_BINS);
+	medians = malloc(sizeof(double) * COMPARE_RESAMPLES);
+	if (!occupied || !counts || !weights || !medians) {
+		fputs("failed to allocate bootstrap\n", stderr);
+		free(occupied);
+		free(counts);
+		free(weights);
+		free(medians);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < COMPARE_BINS; ++i) {
+		if (comparison->bins[i] == 0)
+			continue;
+
+		occupied[len] = i;
+		counts[len++] = comparison->bins[i];
+	}
+
+	verdict->median = exp2(weighted_median(occupied, counts, len,
+		verdict->pairs));
+
+	for (r = 0; r < COMPARE_RESAMPLES; ++r) {
+		total = 0;
+		for (i = 0; i < len; ++i) {
+			weights[i] = poisson(rng, counts[i]);
+			total += weights[i];
+		}
+
+		medians[r] = total > 0
+			? weighted_median(occupied, weights, len, total)
+			: log2(verdict->median);
+	}
+
+	qsort(medians, COMPARE_RESAMPLES, sizeof(double), compare_doubles);
+	tail = COMPARE_RESAMPLES * (1.0 - COMPARE_CONFIDENCE) / 2;
+	verdict->low = exp2(medians[tail]);
+	verdict->high = exp2(medians[COMPARE_RESAMPLES - 1 - tail]);
+
+	free(occupied);
+	free(counts);
+	free(weights);
+	free(medians);
+	return 0;
+}
+
+// pairs up the puzzles both results solved, which needs their columns
+int compare_results(struct comparison* comparison, const struct result* a,
+	const struct result* b, size_t puzzles, struct rng* rng,
+	struct verdict* verdict)
+{
+	size_t n;
+
+	comparison_reset(comparison);
+	for (n = 0; n < puzzles; ++n)
+		if (a->outcomes[n] == OUTCOME_SOLVED
+			&& b->outcomes[n] == OUTCOME_SOLVED)
+			comparison_add(comparison, a->durations[n],
+				b->durations[n]);
+
+	return comparison_judge(comparison, rng, verdict);
+}
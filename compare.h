@@ -0,0 +1,60 @@
+// Sudoku Master Comparison
+//
+// Author: Matthew Knight
+// File Name: compare.h
+// Date: 2026-10-14
+//
+// With --compare every pair of modules is compared head to head on the puzzles
+// both of them solved. For each such puzzle the log of the ratio of the two
+// durations is counted into a fixed grid of bins, and the difference and log
+// ratio are accumulated as moments, so a comparison takes the same space
+// whatever the size of the corpus.
+
+#ifndef COMPARE_H
+#define COMPARE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "random.h"
+#include "runner.h"
+#include "stats.h"
+
+// ratios from 2^-20 to 2^20, each octave split into bins of about 0.3%
+#define COMPARE_OCTAVES 20
+#define COMPARE_BINS_PER_OCTAVE 256
+#define COMPARE_BINS (2 * COMPARE_OCTAVES * COMPARE_BINS_PER_OCTAVE)
+#define COMPARE_RESAMPLES 1000
+#define COMPARE_CONFIDENCE 0.95
+
+struct comparison {
+    uint64_t bins[COMPARE_BINS];
+    struct moments differences;
+    struct moments logs;
+    uint64_t wins;
+    uint64_t losses;
+};
+
+// speedups are how many times faster a was than b, and the difference is in
+// the clock's ticks
+struct verdict {
+    uint64_t pairs;
+    uint64_t wins;
+    uint64_t losses;
+    double mean_difference;
+    double median;
+    double low;
+    double high;
+    double geomean;
+    double p_value;
+};
+
+void comparison_reset(struct comparison* comparison);
+void comparison_add(struct comparison* comparison, uint64_t a, uint64_t b);
+int comparison_judge(const struct comparison* comparison, struct rng* rng,
+	struct verdict* verdict);
+int compare_results(struct comparison* comparison, const struct result* a,
+	const struct result* b, size_t puzzles, struct rng* rng,
+	struct verdict* verdict);
+
+#endif
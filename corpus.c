@@ -0,0 +1,265 @@
+// Sudoku Master Corpus Loader
+//
+// Author: Matthew Knight
+// File Name: corpus.c
+// Date: 2026-10-14
+//
+// Regular files are mapped into memory and parsed in a single pass, anything
+// else (pipes, terminals) is read in large chunks. Either way every puzzle is
+// written once into the contiguous corpus array, so loading is linear in the
+// size of the input.
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "corpus.h"
+
+#define CORPUS_MIN_CAP 1024
+#define CORPUS_CHUNK_SIZE (1 << 20)
+
+static int corpus_reserve(struct corpus* corpus, size_t cap)
+{
+	uint8_t* puzzles;
+
+	if (cap <= corpus->cap)
+		return 0;
+
+	puzzles = realloc(corpus->puzzles, cap * SUDOKU_SIZE);
+	if (!puzzles)
+		return -ENOMEM;
+
+	corpus->puzzles = puzzles;
+	corpus->cap = cap;
+	return 0;
+}
+
+// parses every complete line in buf, and the trailing partial line as well if
+// eof is set. grids are parsed in place into the slot past the end of the
+// corpus. returns the number of bytes consumed
+static ssize_t corpus_parse(struct corpus* corpus, struct parser* parser,
+	const char* buf, size_t len, bool eof)
+{
+	int status;
+	const char *cursor = buf, *end = buf + len, *newline;
+
+	while (cursor < end) {
+		newline = memchr(cursor, '\n', end - cursor);
+		if (!newline) {
+			if (!eof)
+				break;
+
+			newline = end;
+		}
+
+		if (corpus->len == corpus->cap) {
+			status = corpus_reserve(corpus, corpus->cap > 0
+				? corpus->cap * 2 : CORPUS_MIN_CAP);
+			if (status < 0) {
+				fputs("failed to allocate puzzles\n", stderr);
+				return status;
+			}
+		}
+
+		status = parser_line(parser, corpus_get(corpus, corpus->len),
+			cursor, newline - cursor);
+		if (status < 0) {
+			fprintf(stderr, "error parsing line %zu\n",
+				parser->line);
+			return status;
+		}
+
+		corpus->len += status;
+
+		cursor = newline < end ? newline + 1 : end;
+	}
+
+	return cursor - buf;
+}
+
+static int corpus_load_mapped(struct corpus* corpus, int fd, size_t size)
+{
+	int status;
+	ssize_t consumed;
+	char* buf;
+	struct parser parser;
+
+	buf = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (buf == MAP_FAILED)
+		return -errno;
+
+	madvise(buf, size, MADV_SEQUENTIAL);
+
+	// every puzzle takes at least 81 bytes, so this never reallocates
+	status = corpus_reserve(corpus, (size / SUDOKU_SIZE) + 1);
+	if (status < 0) {
+		munmap(buf, size);
+		return status;
+	}
+
+	parser_init(&parser);
+	consumed = corpus_parse(corpus, &parser, buf, size, true);
+	munmap(buf, size);
+
+	if (consumed < 0)
+		return consumed;
+
+	return parser_finish(&parser);
+}
+
+static int corpus_load_stream(struct corpus* corpus, int fd)
+{
+	ssize_t status, consumed;
+	size_t fill = 0;
+	bool eof = false;
+	char* buf;
+	struct parser parser;
+
+	buf = malloc(CORPUS_CHUNK_SIZE);
+	if (!buf)
+		return -ENOMEM;
+
+	parser_init(&parser);
+	while (!eof) {
+		status = read(fd, buf + fill, CORPUS_CHUNK_SIZE - fill);
+		if (status < 0) {
+			if (errno == EINTR)
+				continue;
+
+			fputs("error with file\n", stderr);
+			status = -errno;
+			goto out;
+		}
+
+		eof = status == 0;
+		fill += status;
+
+		consumed = corpus_parse(corpus, &parser, buf, fill, eof);
+		if (consumed < 0) {
+			status = consumed;
+			goto out;
+		}
+
+		if (consumed == 0 && fill == CORPUS_CHUNK_SIZE) {
+			fprintf(stderr, "error parsing line %zu\n",
+				parser.line + 1);
+			status = -1;
+			goto out;
+		}
+
+		fill -= consumed;
+		memmove(buf, buf + consumed, fill);
+	}
+
+	status = parser_finish(&parser);
+
+out:
+	free(buf);
+	return status;
+}
+
+int corpus_load(struct corpus* corpus, int fd)
+{
+	int status;
+	struct stat st;
+
+	memset(corpus, 0, sizeof(*corpus));
+
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+		status = corpus_load_mapped(corpus, fd, st.st_size);
+	else
+		status = corpus_load_stream(corpus, fd);
+
+	if (status < 0) {
+		corpus_free(corpus);
+		return status;
+	}
+
+	return 0;
+}
+
+void corpus_free(struct corpus* corpus)
+{
+	free(corpus->puzzles);
+	memset(corpus, 0, sizeof(*corpus));
+}
+
+uint8_t* corpus_get(const struct corpus* corpus, size_t i)
+{
+	return corpus->puzzles + (i * SUDOKU_SIZE);
+}
+
+void parser_init(struct parser* parser)
+{
+	memset(parser, 0, sizeof(*parser));
+}
+
+static int parse_cells(uint8_t* dst, const char* src, size_t len)
+{
+	int i;
+	unsigned digit;
+
+	for (i = 0; i < len; ++i) {
+		digit = (unsigned char)src[i] - '0';
+		if (digit <= 9)
+			dst[i] = digit;
+		else if (src[i] == '.')
+			dst[i] = 0;
+		else
+			return -1;
+	}
+
+	return 0;
+}
+
+// lines of a nine line puzzle land in successive rows of grid, so the caller
+// hands in the same grid until a puzzle is complete. returns 1 once grid holds
+// a complete puzzle, 0 if more lines are needed, and a negative value for
+// malformed input
+int parser_line(struct parser* parser, uint8_t* grid, const char* line,
+	size_t len)
+{
+	int status;
+
+	parser->line++;
+
+	if (len > 0 && line[len - 1] == '\r')
+		len--;
+
+	if (len == 0)
+		return parser->rows == 0 ? 0 : -1;
+
+	if (len == SUDOKU_SIZE && parser->rows == 0) {
+		status = parse_cells(grid, line, len);
+		return status < 0 ? status : 1;
+	}
+
+	if (len != SUDOKU_AXIS_SIZE)
+		return -1;
+
+	status = parse_cells(&grid[parser->rows * SUDOKU_AXIS_SIZE], line, len);
+	if (status < 0)
+		return status;
+
+	if (++parser->rows < SUDOKU_AXIS_SIZE)
+		return 0;
+
+	parser->rows = 0;
+	return 1;
+}
+
+// a file that ends partway through a nine line puzzle is malformed
+int parser_finish(const struct parser* parser)
+{
+	if (parser->rows != 0) {
+		fputs("error parsing line: truncated puzzle\n", stderr);
+		return -1;
+	}
+
+	return 0;
+}
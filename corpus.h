@@ -0,0 +1,40 @@
+// Sudoku Master Corpus Loader
+//
+// Author: Matthew Knight
+// File Name: corpus.h
+// Date: 2026-10-14
+//
+// Puzzles are parsed straight into one contiguous array of grids, one byte per
+// cell. Two input formats are accepted, and may be mixed within a file: nine
+// lines of nine cells per puzzle, or a single line of 81 cells per puzzle. In
+// either format an empty cell is written as '0' or '.'.
+
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sudoku.h"
+
+struct corpus {
+    uint8_t* puzzles;
+    size_t len;
+    size_t cap;
+};
+
+struct parser {
+    int rows;
+    size_t line;
+};
+
+int corpus_load(struct corpus* corpus, int fd);
+void corpus_free(struct corpus* corpus);
+uint8_t* corpus_get(const struct corpus* corpus, size_t i);
+
+void parser_init(struct parser* parser);
+int parser_line(struct parser* parser, uint8_t* grid, const char* line,
+	size_t len);
+int parser_finish(const struct parser* parser);
+
+#endif
@@ -0,0 +1,203 @@
+// Sudoku Master Daemon
+//
+// Author: Matthew Knight
+// File Name: daemon.c
+// Date: 2026-10-14
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "daemon.h"
+
+static volatile sig_atomic_t expired;
+
+static void daemon_alarm(int signum)
+{
+	(void)signum;
+	expired = 1;
+}
+
+static int daemon_listen(const char* path)
+{
+	int fd;
+	struct sockaddr_un addr;
+
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, "socket path too long: %s\n", path);
+		return -ENAMETOOLONG;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		fputs("failed to create socket\n", stderr);
+		return -errno;
+	}
+
+	// a socket left behind by an earlier daemon is replaced
+	unlink(path);
+	if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0
+		|| listen(fd, SOMAXCONN) < 0) {
+		fprintf(stderr, "failed to listen on %s: %s\n", path,
+			strerror(errno));
+		close(fd);
+		return -errno;
+	}
+
+	return fd;
+}
+
+// reads up to the first newline, or until the client stops sending, giving
+// up on one that hasn't sent anything for DAEMON_READ_TIMEOUT seconds
+static int daemon_read(int fd, char* buf, size_t len)
+{
+	ssize_t status;
+	size_t fill = 0;
+	struct timeval timeout = { .tv_sec = DAEMON_READ_TIMEOUT };
+
+	if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+			sizeof(timeout)) < 0)
+		return -errno;
+
+	while (fill < len - 1) {
+		status = read(fd, buf + fill, len - 1 - fill);
+		if (status < 0 && errno == EINTR)
+			continue;
+		if (status < 0)
+			return -errno;
+		if (status == 0)
+			break;
+
+		fill += status;
+		if (memchr(buf + fill - status, '\n', status))
+			break;
+	}
+
+	buf[fill] = '\0';
+	buf[strcspn(buf, "\n")] = '\0';
+	return 0;
+}
+
+// splits the request into module paths, in place
+static size_t daemon_parse(char* request, char** filenames)
+{
+	size_t modules = 0;
+	char *save, *token = strtok_r(request, " \t\r", &save);
+
+	for (; token && modules < DAEMON_MAX_MODULES;
+		token = strtok_r(NULL, " \t\r", &save))
+		filenames[modules++] = token;
+
+	return modules;
+}
+
+// only returns in a child, with its stdout and stderr connected to the client
+// and the modules it was asked to run, or in the daemon on an error
+int daemon_serve(const char* path, char*** filenames, size_t* modules)
+{
+	int status, listener, client, wstatus;
+	pid_t pid;
+	struct sigaction action;
+	static char request[DAEMON_REQUEST_SIZE];
+	static char* requested[DAEMON_MAX_MODULES];
+
+	listener = daemon_listen(path);
+	if (listener < 0)
+		return listener;
+
+	// a client that hangs up early only takes its own child with it
+	signal(SIGPIPE, SIG_IGN);
+
+	// without SA_RESTART the alarm interrupts the wait for a child
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = daemon_alarm;
+	sigemptyset(&action.sa_mask);
+	if (sigaction(SIGALRM, &action, NULL) < 0) {
+		fputs("failed to install alarm handler\n", stderr);
+		close(listener);
+		return -errno;
+	}
+
+	fprintf(stderr, "listening on %s\n", path);
+
+	for (;;) {
+		client = accept4(listener, NULL, NULL, SOCK_CLOEXEC);
+		if (client < 0) {
+			if (errno == EINTR)
+				continue;
+
+			fputs("failed to accept connection\n", stderr);
+			status = -errno;
+			break;
+		}
+
+		status = daemon_read(client, request, sizeof(request));
+		*modules = status == 0 ? daemon_parse(request, requested) : 0;
+		if (*modules == 0) {
+			dprintf(client, "no modules\n");
+			close(client);
+			continue;
+		}
+
+		fflush(stdout);
+		fflush(stderr);
+
+		pid = fork();
+		if (pid == 0) {
+			signal(SIGPIPE, SIG_DFL);
+			signal(SIGALRM, SIG_DFL);
+			close(listener);
+			dup2(client, STDOUT_FILENO);
+			dup2(client, STDERR_FILENO);
+			close(client);
+
+			*filenames = requested;
+			return 0;
+		}
+
+		if (pid < 0) {
+			dprintf(client, "failed to fork\n");
+			close(client);
+			continue;
+		}
+
+		// a run still going after DAEMON_RUN_LIMIT seconds, stuck in a
+		// module that never returns for example, is killed so that the
+		// requests queued behind it are still served
+		expired = 0;
+		alarm(DAEMON_RUN_LIMIT);
+		while (waitpid(pid, &wstatus, 0) < 0 && errno == EINTR)
+			if (expired)
+				kill(pid, SIGKILL);
+		alarm(0);
+
+		// the client is told if the run was killed, by a module that
+		// crashed it for example
+		if (expired && WIFSIGNALED(wstatus)
+			&& WTERMSIG(wstatus) == SIGKILL)
+			dprintf(client, "run killed after %d seconds\n",
+				DAEMON_RUN_LIMIT);
+		else if (WIFSIGNALED(wstatus))
+			dprintf(client, "run killed by signal %d\n",
+				WTERMSIG(wstatus));
+
+		close(client);
+	}
+
+	close(listener);
+	unlink(path);
+	return status;
+}
@@ -0,0 +1,33 @@
+// Sudoku Master Daemon
+//
+// Author: Matthew Knight
+// File Name: daemon.h
+// Date: 2026-10-14
+//
+// With --daemon PATH the corpus is loaded and checked, and the reference run,
+// just once, and the harness then listens on a unix socket at PATH. A client
+// sends a single line of module paths separated by spaces, and gets back the
+// output of a run with those modules, after which the connection is closed.
+//
+// Each request is served by a forked child, which shares the resident corpus
+// and reference solutions without copying them. The child loads the modules
+// and unloads them by exiting, so a module that's been rebuilt is always
+// loaded afresh, and one that crashes or leaks can't harm the daemon or the
+// requests after it. Requests are served one at a time so that runs never
+// overlap, which is why a client gets DAEMON_READ_TIMEOUT seconds to send its
+// request and a run is killed after DAEMON_RUN_LIMIT seconds: otherwise one
+// that stalled would hold up every request after it.
+
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <stddef.h>
+
+#define DAEMON_REQUEST_SIZE 4096
+#define DAEMON_MAX_MODULES 64
+#define DAEMON_READ_TIMEOUT 10
+#define DAEMON_RUN_LIMIT 3600
+
+int daemon_serve(const char* path, char*** filenames, size_t* modules);
+
+#endif
@@ -0,0 +1,53 @@
+// Sudoku Master Difficulty
+//
+// Author: Matthew Knight
+// File Name: difficulty.c
+// Date: 2026-10-14
+
+#include <string.h>
+
+#include "difficulty.h"
+
+// the most branches a puzzle in each bucket may take
+#define MEDIUM_NODES 16
+#define HARD_NODES 256
+
+const char* const bucket_names[BUCKETS] = {
+	[BUCKET_EASY] = "easy",
+	[BUCKET_MEDIUM] = "medium",
+	[BUCKET_HARD] = "hard",
+	[BUCKET_EXTREME] = "extreme",
+};
+
+enum bucket bucket_of(const struct difficulty* difficulty)
+{
+	if (difficulty->nodes == 0)
+		return BUCKET_EASY;
+	else if (difficulty->nodes <= MEDIUM_NODES)
+		return BUCKET_MEDIUM;
+	else if (difficulty->nodes <= HARD_NODES)
+		return BUCKET_HARD;
+
+	return BUCKET_EXTREME;
+}
+
+// buckets gets the bucket of every puzzle
+void difficulty_classify(const struct corpus* corpus, uint8_t* buckets,
+	struct bucket_stats* stats)
+{
+	size_t n;
+	struct difficulty difficulty;
+	struct bucket_stats* bucket;
+
+	memset(stats, 0, sizeof(*stats) * BUCKETS);
+	for (n = 0; n < corpus->len; ++n) {
+		solver_rate(corpus_get(corpus, n), &difficulty);
+		buckets[n] = bucket_of(&difficulty);
+
+		bucket = &stats[buckets[n]];
+		++bucket->puzzles;
+		bucket->givens += difficulty.givens;
+		bucket->singles += difficulty.singles;
+		bucket->nodes += difficulty.nodes;
+	}
+}
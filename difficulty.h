@@ -0,0 +1,42 @@
+// Sudoku Master Difficulty
+//
+// Author: Matthew Knight
+// File Name: difficulty.h
+// Date: 2026-10-14
+//
+// Puzzles are bucketed by how much search the reference solver needs: easy
+// puzzles fall to singles alone, and the harder buckets take progressively
+// more branches.
+
+#ifndef DIFFICULTY_H
+#define DIFFICULTY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "corpus.h"
+#include "solver.h"
+
+enum bucket {
+    BUCKET_EASY,
+    BUCKET_MEDIUM,
+    BUCKET_HARD,
+    BUCKET_EXTREME,
+    BUCKETS,
+};
+
+// the features summed over the puzzles of one bucket
+struct bucket_stats {
+    size_t puzzles;
+    uint64_t givens;
+    uint64_t singles;
+    uint64_t nodes;
+};
+
+extern const char* const bucket_names[BUCKETS];
+
+enum bucket bucket_of(const struct difficulty* difficulty);
+void difficulty_classify(const struct corpus* corpus, uint8_t* buckets,
+	struct bucket_stats* stats);
+
+#endif
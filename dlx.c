@@ -0,0 +1,204 @@
+// Sudoku Master Dancing Links
+//
+// Author: Matthew Knight
+// File Name: dlx.c
+// Date: 2026-10-14
+//
+// Knuth's algorithm X on dancing links, for the puzzles the bitmask search
+// gives up on. Sudoku is an exact cover of 324 constraints, one for every cell,
+// and one for every digit in every row, column and box, by 729 candidate
+// placements that each satisfy four of them. The givens are covered up front,
+// and the search always branches on the constraint with the fewest placements
+// left.
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "solver.h"
+#include "sudoku.h"
+#include "tables.h"
+
+#define DLX_COLUMNS (4 * SUDOKU_SIZE)
+#define DLX_ROWS (SUDOKU_SIZE * SUDOKU_AXIS_SIZE)
+#define DLX_NODES (1 + DLX_COLUMNS + (4 * DLX_ROWS))
+#define DLX_ROOT 0
+
+struct dlx {
+    uint16_t left[DLX_NODES];
+    uint16_t right[DLX_NODES];
+    uint16_t up[DLX_NODES];
+    uint16_t down[DLX_NODES];
+    uint16_t column[DLX_NODES];
+    uint16_t row[DLX_NODES];
+    uint16_t size[1 + DLX_COLUMNS];
+    bool covered[1 + DLX_COLUMNS];
+    uint16_t chosen[SUDOKU_SIZE];
+    size_t depth;
+    size_t limit;
+    size_t solutions;
+    uint8_t* grid;
+};
+
+static void dlx_cover(struct dlx* x, int c)
+{
+	int i, j;
+
+	x->covered[c] = true;
+	x->right[x->left[c]] = x->right[c];
+	x->left[x->right[c]] = x->left[c];
+	for (i = x->down[c]; i != c; i = x->down[i]) {
+		for (j = x->right[i]; j != i; j = x->right[j]) {
+			x->down[x->up[j]] = x->down[j];
+			x->up[x->down[j]] = x->up[j];
+			--x->size[x->column[j]];
+		}
+	}
+}
+
+static void dlx_uncover(struct dlx* x, int c)
+{
+	int i, j;
+
+	for (i = x->up[c]; i != c; i = x->up[i]) {
+		for (j = x->left[i]; j != i; j = x->left[j]) {
+			++x->size[x->column[j]];
+			x->down[x->up[j]] = j;
+			x->up[x->down[j]] = j;
+		}
+	}
+
+	x->right[x->left[c]] = c;
+	x->left[x->right[c]] = c;
+	x->covered[c] = false;
+}
+
+// the first node of the placement of digit d, 0 based, in cell
+static int dlx_node(int cell, int d)
+{
+	return 1 + DLX_COLUMNS + (4 * ((cell * SUDOKU_AXIS_SIZE) + d));
+}
+
+static void dlx_build(struct dlx* x)
+{
+	int b, c, cell, d, k, r, node;
+	int cols[4];
+
+	for (c = 0; c <= DLX_COLUMNS; ++c) {
+		x->left[c] = c == 0 ? DLX_COLUMNS : c - 1;
+		x->right[c] = c == DLX_COLUMNS ? 0 : c + 1;
+		x->up[c] = x->down[c] = c;
+		x->column[c] = c;
+		x->size[c] = 0;
+		x->covered[c] = false;
+	}
+
+	for (cell = 0; cell < SUDOKU_SIZE; ++cell) {
+		r = cell_units[cell].row;
+		c = cell_units[cell].col;
+		b = cell_units[cell].box;
+		for (d = 0; d < SUDOKU_AXIS_SIZE; ++d) {
+			cols[0] = 1 + cell;
+			cols[1] = 1 + SUDOKU_SIZE + (r * 9) + d;
+			cols[2] = 1 + (2 * SUDOKU_SIZE) + (c * 9) + d;
+			cols[3] = 1 + (3 * SUDOKU_SIZE) + (b * 9) + d;
+
+			node = dlx_node(cell, d);
+			for (k = 0; k < 4; ++k) {
+				x->left[node + k] = node + ((k + 3) % 4);
+				x->right[node + k] = node + ((k + 1) % 4);
+				x->column[node + k] = cols[k];
+				x->row[node + k]
+					= (cell * SUDOKU_AXIS_SIZE) + d;
+
+				x->up[node + k] = x->up[cols[k]];
+				x->down[node + k] = cols[k];
+				x->down[x->up[cols[k]]] = node + k;
+				x->up[cols[k]] = node + k;
+				++x->size[cols[k]];
+			}
+		}
+	}
+}
+
+static void dlx_search(struct dlx* x)
+{
+	int c, best, r, j;
+	size_t d;
+
+	if (x->right[DLX_ROOT] == DLX_ROOT) {
+		if (x->solutions++ == 0)
+			for (d = 0; d < x->depth; ++d)
+				x->grid[x->chosen[d] / SUDOKU_AXIS_SIZE] =
+					(x->chosen[d] % SUDOKU_AXIS_SIZE) + 1;
+
+		return;
+	}
+
+	best = x->right[DLX_ROOT];
+	for (c = x->right[best]; c != DLX_ROOT; c = x->right[c])
+		if (x->size[c] < x->size[best])
+			best = c;
+
+	if (x->size[best] == 0)
+		return;
+
+	dlx_cover(x, best);
+	for (r = x->down[best]; r != best; r = x->down[r]) {
+		x->chosen[x->depth++] = x->row[r];
+		for (j = x->right[r]; j != r; j = x->right[j])
+			dlx_cover(x, x->column[j]);
+
+		dlx_search(x);
+
+		for (j = x->left[r]; j != r; j = x->left[j])
+			dlx_uncover(x, x->column[j]);
+
+		--x->depth;
+		if (x->solutions >= x->limit)
+			break;
+	}
+
+	dlx_uncover(x, best);
+}
+
+// returns the number of solutions found, up to limit
+int dlx_solve(uint8_t* grid, size_t limit)
+{
+	int cell, node, k, solutions;
+	struct dlx* x;
+
+	x = malloc(sizeof(*x));
+	if (!x)
+		return -ENOMEM;
+
+	dlx_build(x);
+	x->depth = 0;
+	x->limit = limit;
+	x->solutions = 0;
+	x->grid = grid;
+
+	// two givens competing for the same constraint can't both be covered
+	for (cell = 0; cell < SUDOKU_SIZE; ++cell) {
+		if (grid[cell] == 0)
+			continue;
+
+		node = dlx_node(cell, grid[cell] - 1);
+		for (k = 0; k < 4 && grid[cell] <= 9; ++k)
+			if (x->covered[x->column[node + k]])
+				break;
+
+		if (k < 4) {
+			free(x);
+			return 0;
+		}
+
+		for (k = 0; k < 4; ++k)
+			dlx_cover(x, x->column[node + k]);
+	}
+
+	dlx_search(x);
+	solutions = x->solutions;
+	free(x);
+	return solutions;
+}
@@ -0,0 +1,116 @@
+// Sudoku Master Raw Export
+//
+// Author: Matthew Knight
+// File Name: export.c
+// Date: 2026-10-14
+//
+// Durations are converted from clock ticks a chunk at a time on their way into
+// the stdio buffer, so even a run of many millions of puzzles is written with
+// a handful of large writes.
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "export.h"
+
+#define EXPORT_BUFFER_SIZE (1 << 20)
+#define EXPORT_CHUNK 8192
+
+static size_t align_up(size_t n)
+{
+	return (n + EXPORT_ALIGN - 1) & ~(size_t)(EXPORT_ALIGN - 1);
+}
+
+static int write_padding(FILE* file, size_t n)
+{
+	static const uint8_t zeros[EXPORT_ALIGN];
+
+	return fwrite(zeros, 1, n, file) == n ? 0 : -1;
+}
+
+static int write_durations(FILE* file, const struct clock_source* clock,
+	const uint64_t* durations, size_t puzzles)
+{
+	size_t n, k, count;
+	uint64_t chunk[EXPORT_CHUNK];
+
+	for (n = 0; n < puzzles; n += count) {
+		count = puzzles - n < EXPORT_CHUNK ? puzzles - n : EXPORT_CHUNK;
+		for (k = 0; k < count; ++k)
+			chunk[k] = clock_to_ns(clock, durations[n + k]);
+
+		if (fwrite(chunk, sizeof(uint64_t), count, file) != count)
+			return -1;
+	}
+
+	return 0;
+}
+
+// the string table is a name and author per module, each nul terminated
+int export_write(const char* path, const struct config* config,
+	const struct result* results, size_t modules, size_t puzzles)
+{
+	int status = 0, i;
+	size_t strings = 0, durations, outcomes;
+	FILE* file;
+	struct export_header header;
+
+	for (i = 0; i < modules; ++i)
+		strings += strlen(results[i].module.name) + 1
+			+ strlen(results[i].module.author) + 1;
+
+	durations = align_up(sizeof(uint64_t) * puzzles);
+	outcomes = align_up(puzzles);
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, EXPORT_MAGIC, sizeof(header.magic));
+	header.version = EXPORT_VERSION;
+	header.modules = modules;
+	header.puzzles = puzzles;
+	header.columns = align_up(sizeof(header) + strings);
+	header.stride = durations + outcomes;
+
+	file = fopen(path, "wb");
+	if (!file) {
+		fprintf(stderr, "failed to open export: %s\n", path);
+		return -errno;
+	}
+
+	setvbuf(file, NULL, _IOFBF, EXPORT_BUFFER_SIZE);
+
+	if (fwrite(&header, sizeof(header), 1, file) != 1)
+		status = -1;
+
+	for (i = 0; status == 0 && i < modules; ++i) {
+		fputs(results[i].module.name, file);
+		fputc('\0', file);
+		fputs(results[i].module.author, file);
+		fputc('\0', file);
+	}
+
+	if (status == 0)
+		status = write_padding(file, header.columns - sizeof(header)
+			- strings);
+
+	for (i = 0; status == 0 && i < modules; ++i) {
+		status = write_durations(file, &config->clock,
+			results[i].durations, puzzles);
+		if (status == 0)
+			status = write_padding(file, durations
+				- sizeof(uint64_t) * puzzles);
+		if (status == 0 && fwrite(results[i].outcomes, 1, puzzles, file)
+			!= puzzles)
+			status = -1;
+		if (status == 0)
+			status = write_padding(file, outcomes - puzzles);
+	}
+
+	if (fclose(file) != 0)
+		status = -1;
+
+	if (status < 0)
+		fprintf(stderr, "failed to write export: %s\n", path);
+
+	return status;
+}
@@ -0,0 +1,41 @@
+// Sudoku Master Raw Export
+//
+// Author: Matthew Knight
+// File Name: export.h
+// Date: 2026-10-14
+//
+// With --export the outcome and duration of every puzzle against every module
+// are written to a binary columnar file. The file is a header, a string table
+// with the name and author of each module, and then for each module a column
+// of durations followed by a column of outcomes, each indexed by puzzle. Every
+// column starts on a 64 byte boundary so the file can be mapped straight into
+// an array by analysis tools.
+
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "corpus.h"
+#include "runner.h"
+
+#define EXPORT_MAGIC "SMEXPORT"
+#define EXPORT_VERSION 2
+#define EXPORT_ALIGN 64
+
+// fields are in the byte order of the machine that wrote the file, and
+// durations are in nanoseconds. outcomes are enum outcome values
+struct export_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t modules;
+    uint64_t puzzles;
+    uint64_t columns;
+    uint64_t stride;
+};
+
+int export_write(const char* path, const struct config* config,
+	const struct result* results, size_t modules, size_t puzzles);
+
+#endif
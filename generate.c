@@ -0,0 +1,305 @@
+// Sudoku Master Generator
+//
+// Author: Matthew Knight
+// File Name: generate.c
+// Date: 2026-10-14
+//
+// A solution grid starts as three random boxes down the diagonal, which never
+// constrain each other, completed by the reference solver, then shuffled by a
+// random relabelling and permutation of its rows, bands, columns and stacks.
+// A puzzle that doesn't hit its target, either by getting stuck on more
+// givens or by falling in the wrong difficulty bucket, is thrown away and
+// another grid is drawn from the same stream, up to a fixed number of grids
+// per puzzle so that a target too rare to hit fails instead of spinning.
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "difficulty.h"
+#include "generate.h"
+#include "random.h"
+#include "solver.h"
+
+#define GENERATE_WRITE_PUZZLES 8192
+
+struct generate_worker {
+    pthread_t thread;
+    const struct generator* generator;
+    struct corpus* corpus;
+    size_t begin;
+    size_t end;
+    _Atomic bool* failed;
+    int status;
+};
+
+static void shuffle(struct rng* rng, uint8_t* vals, size_t len)
+{
+	size_t i, j;
+	uint8_t tmp;
+
+	for (i = len - 1; i > 0; --i) {
+		j = rng_below(rng, i + 1);
+		tmp = vals[i];
+		vals[i] = vals[j];
+		vals[j] = tmp;
+	}
+}
+
+// a band or stack order, then a line order within each of them
+static void shuffle_lines(struct rng* rng, uint8_t* lines)
+{
+	int i, j;
+	uint8_t blocks[3] = { 0, 1, 2 }, within[3];
+
+	shuffle(rng, blocks, 3);
+	for (i = 0; i < 3; ++i) {
+		for (j = 0; j < 3; ++j)
+			within[j] = j;
+
+		shuffle(rng, within, 3);
+		for (j = 0; j < 3; ++j)
+			lines[i * 3 + j] = blocks[i] * 3 + within[j];
+	}
+}
+
+static int generate_solution(struct rng* rng, uint8_t* grid)
+{
+	int b, i, r, c;
+	uint8_t digits[SUDOKU_AXIS_SIZE], rows[SUDOKU_AXIS_SIZE];
+	uint8_t cols[SUDOKU_AXIS_SIZE], labels[SUDOKU_AXIS_SIZE + 1];
+	uint8_t seed[SUDOKU_SIZE];
+	bool transpose;
+
+	memset(seed, 0, sizeof(seed));
+	for (b = 0; b < 3; ++b) {
+		for (i = 0; i < SUDOKU_AXIS_SIZE; ++i)
+			digits[i] = i + 1;
+
+		shuffle(rng, digits, SUDOKU_AXIS_SIZE);
+		for (i = 0; i < SUDOKU_AXIS_SIZE; ++i)
+			seed[(b * 3 + i / 3) * SUDOKU_AXIS_SIZE + b * 3 + i % 3]
+				= digits[i];
+	}
+
+	if (solver_solve(seed, 1) != 1)
+		return -1;
+
+	labels[0] = 0;
+	for (i = 0; i < SUDOKU_AXIS_SIZE; ++i)
+		labels[i + 1] = i + 1;
+
+	shuffle(rng, &labels[1], SUDOKU_AXIS_SIZE);
+	shuffle_lines(rng, rows);
+	shuffle_lines(rng, cols);
+	transpose = rng_next(rng) & 1;
+
+	for (r = 0; r < SUDOKU_AXIS_SIZE; ++r)
+		for (c = 0; c < SUDOKU_AXIS_SIZE; ++c)
+			grid[transpose ? c * SUDOKU_AXIS_SIZE + r
+				: r * SUDOKU_AXIS_SIZE + c]
+				= labels[seed[rows[r] * SUDOKU_AXIS_SIZE
+					+ cols[c]]];
+
+	return 0;
+}
+
+// removes givens in a random order for as long as the solution stays unique,
+// and returns how many are left
+static int generate_dig(struct rng* rng, uint8_t* puzzle, size_t target)
+{
+	int i, givens = SUDOKU_SIZE;
+	uint8_t cells[SUDOKU_SIZE], scratch[SUDOKU_SIZE], given;
+
+	for (i = 0; i < SUDOKU_SIZE; ++i)
+		cells[i] = i;
+
+	shuffle(rng, cells, SUDOKU_SIZE);
+	for (i = 0; i < SUDOKU_SIZE && givens > target; ++i) {
+		given = puzzle[cells[i]];
+		puzzle[cells[i]] = 0;
+
+		memcpy(scratch, puzzle, SUDOKU_SIZE);
+		if (solver_solve(scratch, 2) == 1)
+			--givens;
+		else
+			puzzle[cells[i]] = given;
+	}
+
+	return givens;
+}
+
+static int generate_puzzle(const struct generator* generator, size_t n,
+	uint8_t* puzzle)
+{
+	int attempt;
+	struct rng rng;
+	struct difficulty difficulty;
+	size_t target = generator->givens > 0 ? generator->givens
+		: GENERATE_MIN_GIVENS;
+
+	rng_seed(&rng, generator->seed, n);
+	for (attempt = 0; attempt < GENERATE_ATTEMPTS; ++attempt) {
+		if (generate_solution(&rng, puzzle) < 0)
+			return -1;
+
+		if (generate_dig(&rng, puzzle, target) > generator->givens
+			&& generator->givens > 0)
+			continue;
+
+		if (generator->level < 0)
+			return 0;
+
+		if (solver_rate(puzzle, &difficulty) < 0)
+			return -1;
+
+		if (bucket_of(&difficulty) == generator->level)
+			return 0;
+	}
+
+	return -EAGAIN;
+}
+
+// names the target that ran out of attempts
+static void generate_failed(const struct generator* generator)
+{
+	fputs("no ", stderr);
+	if (generator->level >= 0)
+		fprintf(stderr, "%s ", bucket_names[generator->level]);
+
+	fputs("puzzle ", stderr);
+	if (generator->givens > 0)
+		fprintf(stderr, "with %zu givens ", generator->givens);
+
+	fprintf(stderr, "found in %d attempts\n", GENERATE_ATTEMPTS);
+}
+
+static void* generate_run(void* arg)
+{
+	size_t n;
+	struct generate_worker* worker = arg;
+
+	// once one thread has failed the rest stop at their next puzzle
+	for (n = worker->begin; n < worker->end && !*worker->failed; ++n) {
+		worker->status = generate_puzzle(worker->generator, n,
+			corpus_get(worker->corpus, n));
+		if (worker->status < 0) {
+			if (!atomic_exchange(worker->failed, true)) {
+				if (worker->status == -EAGAIN)
+					generate_failed(worker->generator);
+				else
+					fputs("failed to generate puzzle\n",
+						stderr);
+			}
+
+			return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+// each thread fills a contiguous slice of the corpus in place
+int generate_corpus(const struct generator* generator, struct corpus* corpus)
+{
+	int status = 0;
+	size_t t, threads = generator->threads;
+	struct generate_worker* workers;
+	_Atomic bool failed = false;
+
+	corpus->puzzles = malloc(generator->count * SUDOKU_SIZE);
+	workers = calloc(threads, sizeof(*workers));
+	if (!corpus->puzzles || !workers) {
+		fputs("failed to allocate puzzles\n", stderr);
+		free(workers);
+		return -ENOMEM;
+	}
+
+	corpus->len = corpus->cap = generator->count;
+	for (t = 0; t < threads; ++t) {
+		workers[t].generator = generator;
+		workers[t].corpus = corpus;
+		workers[t].failed = &failed;
+		workers[t].begin = (generator->count * t) / threads;
+		workers[t].end = (generator->count * (t + 1)) / threads;
+	}
+
+	for (t = 1; t < threads; ++t) {
+		status = pthread_create(&workers[t].thread, NULL, generate_run,
+			&workers[t]);
+		if (status != 0) {
+			fputs("failed to start generator\n", stderr);
+			threads = t;
+			status = -status;
+			break;
+		}
+	}
+
+	generate_run(&workers[0]);
+	if (workers[0].status < 0)
+		status = workers[0].status;
+
+	for (t = 1; t < threads; ++t) {
+		pthread_join(workers[t].thread, NULL);
+		if (workers[t].status < 0)
+			status = workers[t].status;
+	}
+
+	free(workers);
+	return status;
+}
+
+// one line of 81 characters per puzzle, the format the loader parses fastest
+int generate_write(const struct corpus* corpus, const char* path)
+{
+	int status = 0, fd, c;
+	size_t n, i, len, size;
+	char *buf, *line;
+	const uint8_t* puzzle;
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		fprintf(stderr, "failed to open %s\n", path);
+		return -errno;
+	}
+
+	buf = malloc((SUDOKU_SIZE + 1) * GENERATE_WRITE_PUZZLES);
+	if (!buf) {
+		close(fd);
+		return -ENOMEM;
+	}
+
+	for (n = 0; n < corpus->len && status == 0; n += len) {
+		len = corpus->len - n < GENERATE_WRITE_PUZZLES
+			? corpus->len - n : GENERATE_WRITE_PUZZLES;
+
+		for (i = 0; i < len; ++i) {
+			puzzle = corpus_get(corpus, n + i);
+			line = &buf[i * (SUDOKU_SIZE + 1)];
+			for (c = 0; c < SUDOKU_SIZE; ++c)
+				line[c] = puzzle[c] ? '0' + puzzle[c] : '.';
+
+			line[SUDOKU_SIZE] = '\n';
+		}
+
+		size = len * (SUDOKU_SIZE + 1);
+		if (write(fd, buf, size) != (ssize_t)size) {
+			fprintf(stderr, "failed to write %s\n", path);
+			status = -EIO;
+		}
+	}
+
+	free(buf);
+	if (close(fd) < 0 && status == 0)
+		status = -errno;
+
+	return status;
+}
@@ -0,0 +1,43 @@
+// Sudoku Master Generator
+//
+// Author: Matthew Knight
+// File Name: generate.h
+// Date: 2026-10-14
+//
+// With --generate N the corpus is made up instead of read. Every puzzle is dug
+// out of a random solution grid, one given at a time, keeping only removals
+// that the reference solver finds leave a single solution, until the target
+// number of givens is reached or no given can be removed. Puzzle i is drawn
+// from stream i of the seed, so a corpus is the same whatever number of
+// threads it was generated on.
+
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "corpus.h"
+
+// fewer givens than this never have a unique solution
+#define GENERATE_MIN_GIVENS 17
+
+// the fewest givens --givens takes. digging gets below this so seldom that
+// most puzzles would run out of attempts first
+#define GENERATE_LOW_GIVENS 22
+
+// random grids drawn for each puzzle before its target is given up on
+#define GENERATE_ATTEMPTS 4096
+
+struct generator {
+    size_t count;
+    size_t givens;
+    int level;
+    size_t threads;
+    uint64_t seed;
+};
+
+int generate_corpus(const struct generator* generator, struct corpus* corpus);
+int generate_write(const struct corpus* corpus, const char* path);
+
+#endif
@@ -0,0 +1,405 @@
+// Sudoku Master Process Isolation
+//
+// Author: Matthew Knight
+// File Name: isolate.c
+// Date: 2026-10-14
+//
+// The corpus is inherited by every child through fork, so the ring only
+// carries puzzle indices one way and a status and duration for each the other
+// way, and no puzzle is ever copied. The parent keeps the ring topped up and
+// collects results behind the child, and while a solve is in flight the child
+// publishes when it started. A child that overruns the timeout is killed and
+// its puzzle is counted as timed out, a child that dies is reaped and its
+// puzzle is counted as lost, and in both cases a fresh child carries on from
+// the next one. Once the run's budget is spent no more puzzles are handed out,
+// and the child stops before starting on any more of those it already has.
+// Once a module has given too many wrong answers its child is killed. A fresh
+// child that can't load the module, or a run of children that all die before
+// finishing a puzzle, fails the module rather than respawning forever.
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "isolate.h"
+
+#define CHANNEL_SLOTS 1024
+#define CHANNEL_STRING_SIZE 80
+#define CHANNEL_POLL_NS 100000
+
+// children in a row that may die without getting through a single puzzle
+// before the module is given up on
+#define ISOLATE_RESPAWNS 8
+
+enum channel_state {
+    CHANNEL_STARTING,
+    CHANNEL_READY,
+    CHANNEL_FAILED,
+};
+
+struct slot {
+    uint64_t index;
+    uint64_t duration;
+    enum outcome outcome;
+    bool divergent;
+    uint64_t counted;
+    uint64_t counters[PERF_COUNTERS];
+    struct effort effort;
+};
+
+// the fields each side writes are kept on cache lines of their own
+struct channel {
+    // written by the parent
+    _Atomic size_t head;
+    _Atomic bool stop;
+    uint64_t deadline;
+
+    // written by the child
+    _Alignas(CACHE_LINE_SIZE) _Atomic size_t tail;
+    _Atomic uint64_t started;
+    _Atomic int state;
+    _Atomic bool expired;
+    unsigned available;
+    char name[CHANNEL_STRING_SIZE];
+    char author[CHANNEL_STRING_SIZE];
+
+    _Alignas(CACHE_LINE_SIZE) struct slot slots[CHANNEL_SLOTS];
+};
+
+static void channel_sleep(long ns)
+{
+	struct timespec req = { .tv_sec = 0, .tv_nsec = ns };
+
+	nanosleep(&req, NULL);
+}
+
+static void __attribute__((noreturn)) isolate_child(struct channel* channel,
+	const char* filename, const struct config* config,
+	const struct corpus* corpus)
+{
+	size_t tail, head;
+	uint64_t duration;
+	enum outcome outcome;
+	struct slot* slot;
+	struct module module;
+	struct worker worker;
+	struct sched_param param;
+
+	// don't outlive the harness if it goes away
+	prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+	// under SCHED_FIFO the harness has to be able to take the cpu back
+	// from a child that hangs
+	if (sched_getscheduler(0) == SCHED_FIFO
+		&& sched_getparam(0, &param) == 0) {
+		--param.sched_priority;
+		sched_setscheduler(0, SCHED_FIFO, &param);
+	}
+
+	memset(&worker, 0, sizeof(worker));
+	worker.config = config;
+	worker.corpus = corpus;
+	worker.deadline = channel->deadline;
+	worker.repeats = calloc(config->repeat, sizeof(uint64_t));
+
+	dlerror();
+	if (!worker.repeats || module_init(&module, filename) < 0
+		|| (config->perf && perf_open(&worker.perf) < 0)) {
+		atomic_store(&channel->state, CHANNEL_FAILED);
+		_exit(EXIT_FAILURE);
+	}
+
+	if (config->perf)
+		channel->available = perf_available(&worker.perf);
+
+	if (config->effort)
+		worker.source = module.stats;
+
+	if (atomic_load(&channel->state) == CHANNEL_STARTING) {
+		strncpy(channel->name, module.name, CHANNEL_STRING_SIZE - 1);
+		strncpy(channel->author, module.author,
+			CHANNEL_STRING_SIZE - 1);
+		atomic_store(&channel->state, CHANNEL_READY);
+	}
+
+	for (;;) {
+		tail = atomic_load_explicit(&channel->tail,
+			memory_order_relaxed);
+		head = atomic_load_explicit(&channel->head,
+			memory_order_acquire);
+
+		if (tail == head) {
+			if (atomic_load(&channel->stop))
+				_exit(EXIT_SUCCESS);
+
+			channel_sleep(CHANNEL_POLL_NS / 10);
+			continue;
+		}
+
+		if (worker_expired(&worker)) {
+			atomic_store(&channel->expired, true);
+			_exit(EXIT_SUCCESS);
+		}
+
+		slot = &channel->slots[tail % CHANNEL_SLOTS];
+		atomic_store_explicit(&channel->started, monotonic_ns(),
+			memory_order_relaxed);
+		outcome = worker_test(&worker, &module, slot->index,
+			&duration);
+		atomic_store_explicit(&channel->started, 0,
+			memory_order_relaxed);
+
+		slot->outcome = outcome;
+		slot->duration = duration;
+		slot->divergent = worker_inspect(&worker, &module, slot->index,
+			outcome, worker.output);
+		slot->counted = 0;
+		memset(slot->counters, 0, sizeof(slot->counters));
+		if (config->perf)
+			perf_drain(&worker.perf, slot->counters,
+				&slot->counted);
+
+		slot->effort = worker.effort;
+		memset(&worker.effort, 0, sizeof(worker.effort));
+
+		atomic_store_explicit(&channel->tail, tail + 1,
+			memory_order_release);
+	}
+}
+
+static pid_t isolate_spawn(struct channel* channel, const char* filename,
+	const struct config* config, const struct corpus* corpus)
+{
+	pid_t pid;
+
+	fflush(stdout);
+	fflush(stderr);
+
+	pid = fork();
+	if (pid == 0)
+		isolate_child(channel, filename, config, corpus);
+
+	return pid;
+}
+
+// collects every result the child has published so far
+static void isolate_collect(struct channel* channel, struct result* result,
+	size_t* collected)
+{
+	int i;
+	struct slot* slot;
+	size_t tail = atomic_load_explicit(&channel->tail,
+		memory_order_acquire);
+
+	for (; *collected < tail; ++*collected) {
+		slot = &channel->slots[*collected % CHANNEL_SLOTS];
+		result->elapsed += slot->duration;
+		result->counted += slot->counted;
+		for (i = 0; i < PERF_COUNTERS; ++i)
+			result->counters[i] += slot->counters[i];
+
+		effort_merge(&result->effort, &slot->effort);
+
+		if (result->outcomes) {
+			result->durations[slot->index] = slot->duration;
+			result->outcomes[slot->index] = slot->outcome;
+		}
+
+		++result->tally.tested;
+		if (slot->outcome == OUTCOME_INCORRECT)
+			++result->tally.incorrect;
+
+		if (slot->divergent)
+			++result->tally.divergent;
+
+		if (slot->outcome == OUTCOME_SOLVED)
+			samples_append(&result->samples, slot->duration);
+	}
+}
+
+static int isolate_module(const struct config* config,
+	const struct corpus* corpus, struct result* result,
+	struct channel* channel, const char* filename, uint64_t deadline)
+{
+	int wstatus, respawns = 0;
+	bool lost, timed_out;
+	pid_t pid;
+	size_t head, index, next = 0, collected = 0, len = corpus->len;
+	size_t spawned = 0;
+	uint64_t started, timeout;
+
+	// the child is stamped once for the warmups and repeats of a puzzle
+	// together, so the limit on a single solve is given to each of them
+	timeout = config->timeout * (config->warmup + config->repeat);
+
+	memset(channel, 0, sizeof(*channel));
+	channel->deadline = deadline;
+
+	pid = isolate_spawn(channel, filename, config, corpus);
+	if (pid < 0)
+		return -errno;
+
+	while (atomic_load(&channel->state) == CHANNEL_STARTING) {
+		if (waitpid(pid, &wstatus, WNOHANG) == pid)
+			break;
+
+		channel_sleep(CHANNEL_POLL_NS);
+	}
+
+	if (atomic_load(&channel->state) != CHANNEL_READY) {
+		waitpid(pid, &wstatus, 0);
+		return -1;
+	}
+
+	result->module.name = channel->name;
+	result->module.author = channel->author;
+	result->available = channel->available;
+
+	while (collected < len) {
+		if (deadline > 0 && monotonic_ns() >= deadline)
+			len = next;
+
+		head = atomic_load_explicit(&channel->head,
+			memory_order_relaxed);
+		for (; head - collected < CHANNEL_SLOTS && next < len; ++head)
+			channel->slots[head % CHANNEL_SLOTS].index = next++;
+
+		atomic_store_explicit(&channel->head, head,
+			memory_order_release);
+
+		isolate_collect(channel, result, &collected);
+		if (collected == len)
+			break;
+
+		// a module past its limit of wrong answers is abandoned along
+		// with whatever it has been handed, which stays untested
+		if (config->max_incorrect > 0
+			&& result->tally.incorrect >= config->max_incorrect) {
+			kill(pid, SIGKILL);
+			waitpid(pid, &wstatus, 0);
+			return 0;
+		}
+
+		lost = false;
+		timed_out = false;
+		started = atomic_load_explicit(&channel->started,
+			memory_order_relaxed);
+		if (config->timeout > 0 && started != 0
+			&& monotonic_ns() - started > timeout) {
+			kill(pid, SIGKILL);
+			waitpid(pid, &wstatus, 0);
+			lost = true;
+			timed_out = true;
+		} else if (waitpid(pid, &wstatus, WNOHANG) == pid) {
+			// a child that ran out of budget leaves the rest of
+			// what it was handed untested
+			if (atomic_load(&channel->expired)) {
+				isolate_collect(channel, result, &collected);
+				return 0;
+			}
+
+			// as when the .so is rebuilt or removed mid run
+			if (atomic_load(&channel->state) == CHANNEL_FAILED) {
+				fprintf(stderr, "%s failed to reload\n",
+					filename);
+				return -1;
+			}
+
+			lost = true;
+		}
+
+		if (!lost) {
+			channel_sleep(CHANNEL_POLL_NS);
+			continue;
+		}
+
+		// the child may have finished more puzzles on its way out. if
+		// it died mid solve, the puzzle it was on is lost
+		isolate_collect(channel, result, &collected);
+		if (atomic_load(&channel->started) != 0) {
+			index = channel->slots[collected % CHANNEL_SLOTS].index;
+			fprintf(stderr, "%s %s on puzzle %zu, restarting\n",
+				filename, timed_out ? "timed out" : "died",
+				index);
+			if (result->outcomes)
+				result->outcomes[index] = timed_out
+					? OUTCOME_TIMEOUT : OUTCOME_LOST;
+
+			++result->tally.tested;
+			if (timed_out)
+				++result->tally.timeouts;
+
+			atomic_store(&channel->started, 0);
+			atomic_store(&channel->tail, ++collected);
+		}
+
+		if (collected == len)
+			break;
+
+		// a lost puzzle counts as progress, so this only trips on
+		// children that die before they get to one
+		respawns = collected == spawned ? respawns + 1 : 0;
+		spawned = collected;
+		if (respawns >= ISOLATE_RESPAWNS) {
+			fprintf(stderr, "%s died %d times without progress\n",
+				filename, respawns);
+			return -1;
+		}
+
+		pid = isolate_spawn(channel, filename, config, corpus);
+		if (pid < 0)
+			return -errno;
+	}
+
+	atomic_store(&channel->stop, true);
+	waitpid(pid, &wstatus, 0);
+	return 0;
+}
+
+int isolate_run(const struct config* config, const struct corpus* corpus,
+	struct result* results, char* const* filenames, size_t modules)
+{
+	int status, i;
+	uint64_t deadline = 0;
+	struct channel* channels;
+
+	channels = mmap(NULL, sizeof(struct channel) * modules,
+		PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (channels == MAP_FAILED) {
+		fputs("failed to map channels\n", stderr);
+		return -errno;
+	}
+
+	if (config->budget > 0)
+		deadline = monotonic_ns() + config->budget;
+
+	for (i = 0; i < modules; ++i) {
+		status = isolate_module(config, corpus, &results[i],
+			&channels[i], filenames[i], deadline);
+		if (status < 0) {
+			fprintf(stderr, "failed to load module: %s\n",
+				filenames[i]);
+			return status;
+		}
+
+		status = samples_sort(&results[i].samples);
+		if (status < 0) {
+			fputs("failed to sort samples\n", stderr);
+			return status;
+		}
+	}
+
+	return 0;
+}
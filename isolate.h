@@ -0,0 +1,22 @@
+// Sudoku Master Process Isolation
+//
+// Author: Matthew Knight
+// File Name: isolate.h
+// Date: 2026-10-14
+//
+// In isolation mode the harness never loads a module itself. Each module is
+// loaded and run in a forked child of its own, one module at a time, and
+// puzzles and results are passed through a ring in shared memory.
+
+#ifndef ISOLATE_H
+#define ISOLATE_H
+
+#include <stddef.h>
+
+#include "corpus.h"
+#include "runner.h"
+
+int isolate_run(const struct config* config, const struct corpus* corpus,
+	struct result* results, char* const* filenames, size_t modules);
+
+#endif
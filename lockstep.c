@@ -0,0 +1,371 @@
+// Sudoku Master Lockstep Solver
+//
+// Author: Matthew Knight
+// File Name: lockstep.c
+// Date: 2026-10-14
+//
+// The candidates of every cell are kept as a vector with one 9 bit mask per
+// lane, and each sweep of the grid propagates all the lanes together: the
+// digit of every naked single is cleared from its peers, and hidden singles
+// are found per unit by folding its cells into masks of digits seen once and
+// seen twice. Sweeps repeat until no lane changes, and then each lane is
+// looked at on its own. A solved lane writes out its solution and takes the
+// next puzzle of the batch, a lane with an empty cell or a unit missing a
+// digit backtracks, and the rest branch on their cell with the fewest
+// candidates, saving their own column of the vectors to come back to. Lanes
+// go through the search at different depths, but always sweep together.
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lockstep.h"
+#include "solver.h"
+#include "tables.h"
+
+#define ALL_DIGITS 0x1ff
+
+typedef uint16_t lanes __attribute__((vector_size(2 * LOCKSTEP_LANES)));
+typedef uint64_t words __attribute__((vector_size(2 * LOCKSTEP_LANES)));
+
+// the state a lane branched from, and the candidates of the branch cell it
+// has still to try
+struct frame {
+    uint16_t cells[SUDOKU_SIZE];
+    uint16_t rest;
+    uint8_t cell;
+};
+
+// grid is null while the lane is idle
+struct lane {
+    uint8_t* grid;
+    size_t nodes;
+    int depth;
+    struct frame frames[SUDOKU_SIZE];
+};
+
+// done holds the singles that have already been cleared from their peers
+struct lockstep {
+    lanes cells[SUDOKU_SIZE];
+    lanes done[SUDOKU_SIZE];
+    lanes dead;
+    lanes open;
+    struct lane lanes[LOCKSTEP_LANES];
+};
+
+static inline __attribute__((always_inline)) bool any(const lanes* v)
+{
+	words w = (words)*v;
+	int i;
+
+	for (i = 1; i < sizeof(words) / sizeof(uint64_t); ++i)
+		w[0] |= w[i];
+
+	return w[0] != 0;
+}
+
+// propagates every lane until none of them changes. dead is left set in the
+// lanes with a contradiction and open in those with a cell still to fill.
+// it's always inlined into the variants below, each of which is built for
+// its own instruction set
+static inline __attribute__((always_inline)) void sweep(struct lockstep* s)
+{
+	int c, u, k;
+	lanes v, w, single, once, twice, hidden, hit, changed;
+	const lanes zero = { 0 };
+	const lanes all = zero + ALL_DIGITS;
+
+	do {
+		changed = zero;
+		s->dead = zero;
+		s->open = zero;
+
+		for (c = 0; c < SUDOKU_SIZE; ++c) {
+			v = s->cells[c];
+			s->dead |= (lanes)(v == 0);
+			single = (lanes)((v & (v - 1)) == 0) & v;
+			s->open |= (lanes)(single == 0);
+			single &= ~s->done[c];
+			if (!any(&single))
+				continue;
+
+			s->done[c] |= single;
+			for (k = 0; k < SUDOKU_PEERS; ++k) {
+				w = s->cells[peers[c][k]];
+				changed |= w & single;
+				s->cells[peers[c][k]] = w & ~single;
+			}
+		}
+
+		for (u = 0; u < SUDOKU_UNITS; ++u) {
+			once = zero;
+			twice = zero;
+			for (k = 0; k < SUDOKU_AXIS_SIZE; ++k) {
+				v = s->cells[units[u][k]];
+				twice |= once & v;
+				once |= v;
+			}
+
+			s->dead |= (lanes)(once != all);
+			hidden = once & ~twice;
+			for (k = 0; k < SUDOKU_AXIS_SIZE; ++k) {
+				v = s->cells[units[u][k]];
+				hit = (lanes)((v & hidden) != 0);
+				w = (v & hidden & hit) | (v & ~hit);
+				changed |= v ^ w;
+				s->cells[units[u][k]] = w;
+			}
+		}
+	} while (any(&changed));
+}
+
+#ifdef HAVE_LOCKSTEP
+__attribute__((target("avx512bw,avx512vl")))
+static void sweep_avx512(struct lockstep* s)
+{
+	sweep(s);
+}
+
+__attribute__((target("avx2")))
+static void sweep_avx2(struct lockstep* s)
+{
+	sweep(s);
+}
+#endif
+
+// without either, 16 lanes of the baseline instruction set are no faster than
+// the reference solver, so the batch is handed to it a puzzle at a time
+static void (*lockstep_sweep)(struct lockstep*);
+
+// picks the widest variant the cpu runs, and returns its name
+const char* lockstep_select(void)
+{
+#ifdef HAVE_LOCKSTEP
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512bw")
+		&& __builtin_cpu_supports("avx512vl")) {
+		lockstep_sweep = sweep_avx512;
+		return "avx512";
+	}
+
+	if (__builtin_cpu_supports("avx2")) {
+		lockstep_sweep = sweep_avx2;
+		return "avx2";
+	}
+#endif
+
+	lockstep_sweep = NULL;
+	return "scalar";
+}
+
+static void lane_load(struct lockstep* s, int l, uint8_t* grid)
+{
+	int c;
+	struct lane* lane = &s->lanes[l];
+
+	lane->grid = grid;
+	lane->nodes = 0;
+	lane->depth = 0;
+	for (c = 0; c < SUDOKU_SIZE; ++c) {
+		s->cells[c][l] = grid[c] >= 1 && grid[c] <= SUDOKU_AXIS_SIZE
+			? 1u << (grid[c] - 1) : ALL_DIGITS;
+		s->done[c][l] = 0;
+	}
+}
+
+// an idle lane has every candidate everywhere, which no sweep changes
+static void lane_idle(struct lockstep* s, int l)
+{
+	int c;
+
+	s->lanes[l].grid = NULL;
+	for (c = 0; c < SUDOKU_SIZE; ++c) {
+		s->cells[c][l] = ALL_DIGITS;
+		s->done[c][l] = 0;
+	}
+}
+
+static void lane_store(const struct lockstep* s, int l)
+{
+	int c;
+	uint8_t* grid = s->lanes[l].grid;
+
+	for (c = 0; c < SUDOKU_SIZE; ++c)
+		grid[c] = __builtin_ctz(s->cells[c][l]) + 1;
+}
+
+static void lane_branch(struct lockstep* s, int l)
+{
+	int c, count, best = -1, fewest = SUDOKU_AXIS_SIZE + 1;
+	uint16_t bit;
+	struct lane* lane = &s->lanes[l];
+	struct frame* frame = &lane->frames[lane->depth++];
+
+	for (c = 0; c < SUDOKU_SIZE && fewest > 2; ++c) {
+		count = __builtin_popcount(s->cells[c][l]);
+		if (count > 1 && count < fewest) {
+			fewest = count;
+			best = c;
+		}
+	}
+
+	for (c = 0; c < SUDOKU_SIZE; ++c)
+		frame->cells[c] = s->cells[c][l];
+
+	bit = frame->cells[best] & -frame->cells[best];
+	frame->cell = best;
+	frame->rest = frame->cells[best] & ~bit;
+	s->cells[best][l] = bit;
+}
+
+// returns false once the lane has run out of branches to try. a frame is only
+// saved once its lane has stopped changing, so every single in it had already
+// been cleared from its peers, except for the cell branched on
+static bool lane_backtrack(struct lockstep* s, int l)
+{
+	int c;
+	uint16_t bit, v;
+	struct lane* lane = &s->lanes[l];
+	struct frame* frame;
+
+	if (lane->depth == 0)
+		return false;
+
+	frame = &lane->frames[lane->depth - 1];
+	for (c = 0; c < SUDOKU_SIZE; ++c) {
+		v = frame->cells[c];
+		s->cells[c][l] = v;
+		s->done[c][l] = (v & (v - 1)) == 0 ? v : 0;
+	}
+
+	bit = frame->rest & -frame->rest;
+	frame->rest &= ~bit;
+	s->cells[frame->cell][l] = bit;
+	s->done[frame->cell][l] = 0;
+	if (frame->rest == 0)
+		--lane->depth;
+
+	return true;
+}
+
+int lockstep_solve(uint8_t* grid)
+{
+	return solver_solve(grid, 1) == 1 ? 0 : -1;
+}
+
+// puzzles without a solution are left as they were. the lanes' stacks come
+// to a few hundred kilobytes, and live on the stack so that no call pays for
+// faulting them in
+int lockstep_solve_batch(uint8_t* grids, size_t n)
+{
+	int l, active = 0;
+	size_t next = 0;
+	struct lockstep engine;
+	struct lockstep* s = &engine;
+
+	if (!lockstep_sweep) {
+		for (next = 0; next < n; ++next)
+			solver_solve(&grids[SUDOKU_SIZE * next], 1);
+
+		return 0;
+	}
+
+	for (l = 0; l < LOCKSTEP_LANES; ++l)
+		lane_idle(s, l);
+
+	for (;;) {
+		for (l = 0; l < LOCKSTEP_LANES && next < n; ++l) {
+			if (s->lanes[l].grid)
+				continue;
+
+			lane_load(s, l, &grids[SUDOKU_SIZE * next++]);
+			++active;
+		}
+
+		if (active == 0)
+			break;
+
+		lockstep_sweep(s);
+
+		for (l = 0; l < LOCKSTEP_LANES; ++l) {
+			struct lane* lane = &s->lanes[l];
+
+			if (!lane->grid)
+				continue;
+
+			if (s->dead[l]) {
+				if (lane_backtrack(s, l))
+					continue;
+			} else if (!s->open[l]) {
+				lane_store(s, l);
+			} else if (++lane->nodes > LOCKSTEP_NODE_LIMIT) {
+				solver_solve(lane->grid, 1);
+			} else {
+				lane_branch(s, l);
+				continue;
+			}
+
+			lane_idle(s, l);
+			--active;
+		}
+	}
+
+	return 0;
+}
+
+int lockstep_run(const struct config* config, const struct corpus* corpus,
+	struct result* result)
+{
+	int status;
+	struct worker worker;
+	struct config lockstep = *config;
+
+	memset(result, 0, sizeof(*result));
+	result->module.name = LOCKSTEP_NAME;
+	result->module.author = LOCKSTEP_AUTHOR;
+	result->module.solve_u8 = lockstep_solve;
+	result->module.solve_batch_u8 = lockstep_solve_batch;
+	result->samples.data = calloc(corpus->len, sizeof(uint64_t));
+	result->samples.cap = corpus->len;
+	if (!result->samples.data) {
+		fputs("failed to allocate lockstep\n", stderr);
+		return -ENOMEM;
+	}
+
+	if (config->difficulty || config->compare) {
+		status = results_columns(result, 1, corpus->len);
+		if (status < 0)
+			return status;
+	}
+
+	if (config->cold) {
+		result->cold = malloc(sizeof(struct histogram));
+		if (!result->cold) {
+			fputs("failed to allocate lockstep\n", stderr);
+			return -ENOMEM;
+		}
+
+		histogram_reset(result->cold);
+	}
+
+	// like the reference it's timed on one thread, without a budget, and
+	// its batches are large enough to refill the lanes that finish early
+	lockstep.threads = 1;
+	lockstep.budget = 0;
+	if (lockstep.batch < LOCKSTEP_BATCH)
+		lockstep.batch = LOCKSTEP_BATCH;
+
+	status = workers_run(&worker, &lockstep, corpus, result, 1);
+	if (status < 0)
+		return status;
+
+	status = workers_merge(&worker, 1, result, 1);
+	if (status < 0) {
+		fputs("failed to sort samples\n", stderr);
+		return status;
+	}
+
+	return 0;
+}
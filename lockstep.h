@@ -0,0 +1,44 @@
+// Sudoku Master Lockstep Solver
+//
+// Author: Matthew Knight
+// File Name: lockstep.h
+// Date: 2026-10-14
+//
+// With --lockstep the corpus is also solved by a built-in engine that works on
+// 16 puzzles at once, one per lane of a vector of candidate masks, so that the
+// modules have a throughput ceiling to be measured against. It's driven
+// through the batch ABI like any batched module. The vector code is built for
+// AVX-512 and AVX2, one of which is picked when the run starts from what the
+// cpu supports, and on cpus with neither the batch falls back to the
+// reference solver.
+
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "corpus.h"
+#include "runner.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAVE_LOCKSTEP 1
+#endif
+
+#define LOCKSTEP_NAME "lockstep"
+#define LOCKSTEP_AUTHOR "sudoku-master"
+
+#define LOCKSTEP_LANES 16
+#define LOCKSTEP_BATCH (16 * LOCKSTEP_LANES)
+
+// a lane hands its puzzle over to the reference solver past this many
+// branches, rather than hold up the lanes around it
+#define LOCKSTEP_NODE_LIMIT 10000
+
+const char* lockstep_select(void);
+int lockstep_run(const struct config* config, const struct corpus* corpus,
+	struct result* result);
+int lockstep_solve(uint8_t* grid);
+int lockstep_solve_batch(uint8_t* grids, size_t n);
+
+#endif
@@ -8,8 +8,12 @@
 // against a set of sudoku puzzles. The timing statistics are written to stdout
 // in csv format.
 
+#define _GNU_SOURCE
+
 #include <dlfcn.h>
 #include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
 #include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
@@ -17,430 +21,1051 @@
 #include <string.h>
 #include <time.h>
 #include <stdint.h>
+#include <unistd.h>
+
+#include "canon.h"
+#include "check.h"
+#include "compare.h"
+#include "corpus.h"
+#include "daemon.h"
+#include "difficulty.h"
+#include "export.h"
+#include "generate.h"
+#include "isolate.h"
+#include "lockstep.h"
+#include "module.h"
+#include "perf.h"
+#include "pressure.h"
+#include "reference.h"
+#include "runner.h"
+#include "shard.h"
+#include "stable.h"
+#include "stream.h"
+#include "stats.h"
+#include "sudoku.h"
+#include "timing.h"
+
+static const struct option options[] = {
+	{ "threads", required_argument, NULL, 't' },
+	{ "clock", required_argument, NULL, 'c' },
+	{ "batch", required_argument, NULL, 'b' },
+	{ "warmup", required_argument, NULL, 'w' },
+	{ "repeat", required_argument, NULL, 'r' },
+	{ "reduce", required_argument, NULL, 'R' },
+	{ "schedule", required_argument, NULL, 'S' },
+	{ "seed", required_argument, NULL, 's' },
+	{ "isolate", no_argument, NULL, 'i' },
+	{ "timeout", required_argument, NULL, 'T' },
+	{ "budget", required_argument, NULL, 'B' },
+	{ "stable", required_argument, NULL, 'P' },
+	{ "compare", no_argument, NULL, 'C' },
+	{ "generate", required_argument, NULL, 'G' },
+	{ "givens", required_argument, NULL, 'K' },
+	{ "level", required_argument, NULL, 'L' },
+	{ "output", required_argument, NULL, 'O' },
+	{ "daemon", required_argument, NULL, 'U' },
+	{ "coordinator", required_argument, NULL, 'X' },
+	{ "worker", required_argument, NULL, 'W' },
+	{ "shard", required_argument, NULL, 'Z' },
+	{ "perf", no_argument, NULL, 'p' },
+	{ "effort", no_argument, NULL, 'E' },
+	{ "max-incorrect", required_argument, NULL, 'M' },
+	{ "failures", required_argument, NULL, 'A' },
+	{ "cold", required_argument, NULL, 'Y' },
+	{ "hog", required_argument, NULL, 'H' },
+	{ "export", required_argument, NULL, 'e' },
+	{ "reference", no_argument, NULL, 'F' },
+	{ "lockstep", no_argument, NULL, 'J' },
+	{ "dedup", no_argument, NULL, 'D' },
+	{ "difficulty", no_argument, NULL, 'd' },
+	{ "stream", no_argument, NULL, 'm' },
+	{ "every", required_argument, NULL, 'N' },
+	{ "interval", required_argument, NULL, 'I' },
+	{ "help", no_argument, NULL, 'h' },
+	{ NULL, 0, NULL, 0 }
+};
 
-#define SUDOKU_SIZE 81
-#define SUDOKU_AXIS_SIZE 9
-
-#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof(arr[0]))
+int run_in_process(struct config* config, const struct corpus* corpus,
+	struct result* results, char* const* filenames, size_t modules)
+{
+	int status, i;
+	struct worker* workers;
 
-typedef int (*iterator_t)(int,int);
+	// clear any potential dlerrors
+	dlerror();
 
-struct module {
-    void* handle;
-    const char* name;
-    const char* author;
-    int (*solve)(int*);
-};
+	// load all the modules
+	for (i = 0; i < modules; ++i) {
+		status = module_init(&results[i].module, filenames[i]);
+		if (status < 0) {
+			fprintf(stderr,
+				"failed to load module: %s\n", filenames[i]);
+			return status;
+		}
+	}
 
-struct result {
-    struct module module;
-    size_t successes;
-    size_t incorrect;
-    uint64_t* data;
-};
+	if (config->threads > corpus->len)
+		config->threads = corpus->len;
 
-struct list_node {
-    struct list_node* next;
-    int puzzle[SUDOKU_SIZE];
-};
+	workers = aligned_alloc(CACHE_LINE_SIZE,
+		sizeof(struct worker) * config->threads);
+	if (!workers) {
+		fputs("failed to allocate workers\n", stderr);
+		return -ENOMEM;
+	}
 
-int module_init(struct module* module, const char* filename);
-int module_get_symbol(void* handle, void** dst, const char* sym);
+	status = workers_run(workers, config, corpus, results, modules);
+	if (status < 0)
+		return status;
 
-int check(const int* puzzle);
-int cross_check(const int* puzzle, int* solution);
-int test(const struct module* module, int* puzzle, uint64_t* duration);
+	status = workers_merge(workers, config->threads, results, modules);
+	if (status < 0) {
+		fputs("failed to sort samples\n", stderr);
+		return status;
+	}
 
-void list_append(struct list_node** list, struct list_node* node);
-size_t list_size(const struct list_node* list);
+	free(workers);
+	return 0;
+}
 
-int check_iterator(const int* puzzle, int (*iterator)(int, int), int i);
-int row_iterator(int row, int col);
-int col_iterator(int col, int row);
-int cell_iterator(int cell, int pos);
+int parse_count(const char* arg, size_t* val, size_t min, const char* what)
+{
+	char* end;
 
-int insert(uint64_t *arr, size_t len, size_t max, uint64_t val);
-uint64_t timespec_to_us(struct timespec* val);
+	*val = strtoul(arg, &end, 10);
+	if (*arg == '\0' || *end != '\0' || *val < min) {
+		fprintf(stderr, "invalid %s: %s\n", what, arg);
+		return -1;
+	}
 
-char peek(FILE* stream) {
-	char ret = getc(stream);
-	return ungetc(ret, stream);
+	return 0;
 }
 
-int main(int argc, char* argv[])
+// a byte count, with an optional K, M or G suffix for powers of 1024
+int parse_size(const char* arg, size_t* val, size_t min, const char* what)
 {
-	int status, i, j;
-	size_t list_len;
-	struct list_node *list = NULL, *node;
-	struct result* results;
-	struct timespec res;
+	char* end;
+	int shift = 0;
+
+	*val = strtoul(arg, &end, 10);
+	if (*end == 'K')
+		shift = 10;
+	else if (*end == 'M')
+		shift = 20;
+	else if (*end == 'G')
+		shift = 30;
+
+	if (shift > 0)
+		++end;
+
+	if (*arg == '\0' || end == arg || *end != '\0'
+		|| *val > (SIZE_MAX >> shift) || (*val << shift) < min) {
+		fprintf(stderr, "invalid %s: %s\n", what, arg);
+		return -1;
+	}
 
-	while (!feof(stdin) && peek(stdin) != EOF) {
-		const char *error;
-		char buf[SUDOKU_AXIS_SIZE][SUDOKU_AXIS_SIZE + 2];
-		struct list_node* node;
+	*val <<= shift;
+	return 0;
+}
 
-		if ((argc - 1) < 1) {
-			fputs("no modules\n", stderr);
-			return -1;
-		}
+// averages per solve, with counters the machine doesn't have left empty
+void print_counters(const struct result* result)
+{
+	int i;
+	const uint64_t* counters = result->counters;
+	unsigned available = result->counted > 0 ? result->available : 0;
+
+	for (i = 0; i < PERF_COUNTERS; ++i) {
+		if (available & (1u << i))
+			printf(",%.1f", (double)counters[i] / result->counted);
+		else
+			putchar(',');
+
+		if (i != PERF_INSTRUCTIONS)
+			continue;
+
+		if ((available & (1u << PERF_CYCLES))
+			&& (available & (1u << PERF_INSTRUCTIONS))
+			&& counters[PERF_CYCLES] > 0)
+			printf(",%.2f", (double)counters[PERF_INSTRUCTIONS]
+				/ counters[PERF_CYCLES]);
+		else
+			putchar(',');
+	}
+}
 
-		for (i = 0; i < ARRAY_SIZE(buf); ++i) {
-			if (fgets(buf[i], SUDOKU_AXIS_SIZE + 2, stdin) == NULL) {
-				if (feof(stdin)) {
-					printf("got eof, i: %d\n", i);
-				}
+// averages per solve, and the time per node over the module's whole run,
+// left empty for a module that doesn't report its effort
+void print_effort(const struct config* config, const struct result* result)
+{
+	const struct effort* effort = &result->effort;
+	const struct solver_stats* stats = &effort->stats;
+	double solves = effort->solves, per_puzzle;
 
-				if (ferror(stdin)) {
-					fputs("error with file\n", stderr);
-					return -1;
-				}
-			}
+	if (effort->solves == 0) {
+		fputs(",,,,,", stdout);
+		return;
+	}
 
-			if (strlen(buf[i]) != SUDOKU_AXIS_SIZE + 1) {
-				fputs("error parsing line\n", stderr);
-				return -1;
-			}
-		}
+	printf(",%.1f,%.1f,%.1f,%.1f", stats->nodes / solves,
+		stats->guesses / solves, stats->backtracks / solves,
+		stats->propagations / solves);
+
+	// the elapsed time only has one reduced duration for every puzzle
+	per_puzzle = clock_to_ns_f(&config->clock, result->elapsed)
+		/ result->tally.tested;
+	if (stats->nodes > 0)
+		printf(",%.1f", per_puzzle / (stats->nodes / solves));
+	else
+		putchar(',');
+}
 
-		node = malloc(sizeof(struct list_node));
-		if (!node) {
-			fputs("failed to allocate puzzle node\n", stderr);
-			return -ENOMEM;
-		}
+// the success count, median and p99 of the puzzles in each difficulty bucket
+int print_buckets(const struct config* config, const struct result* result,
+	size_t list_len)
+{
+	int b, status = 0;
+	size_t n;
+	struct summary summary;
+	struct samples samples = { .cap = list_len };
+	const struct clock_source* clock = &config->clock;
+
+	samples.data = malloc(sizeof(uint64_t) * list_len);
+	if (!samples.data) {
+		fputs("failed to allocate bucket samples\n", stderr);
+		return -ENOMEM;
+	}
 
-		for (i = 0; i < SUDOKU_AXIS_SIZE; ++i)
-			for (j = 0; j < SUDOKU_AXIS_SIZE; ++j)
-				node->puzzle[row_iterator(i, j)]
-					= (int)buf[i][j] - 0x30;
+	for (b = 0; b < BUCKETS; ++b) {
+		samples.len = 0;
+		for (n = 0; n < list_len; ++n)
+			if (config->buckets[n] == b
+				&& result->outcomes[n] == OUTCOME_SOLVED)
+				samples_append(&samples, result->durations[n]);
 
-		status = check(node->puzzle);
+		status = samples_sort(&samples);
 		if (status < 0) {
-			fputs("invalid puzzle\n", stderr);
-			return status;
+			fputs("failed to sort bucket samples\n", stderr);
+			break;
 		}
 
-		list_append(&list, node);
+		summary_compute(&summary, &samples);
+		printf(",%zu,%zu,%zu", samples.len,
+			clock_to_ns(clock, summary.median),
+			clock_to_ns(clock, summary.p99));
 	}
 
-	list_len = list_size(list);
-	if (list_len == 0) {
-		fputs("no puzzles\n", stderr);
-		return -1;
-	}
+	free(samples.data);
+	return status;
+}
 
-	results = calloc(sizeof(struct result) + (sizeof(uint64_t) * list_len),
-		argc - 1);
-	if (!results) {
-		fputs("failed to allocate results\n", stderr);
-		return -ENOMEM;
+// with a reference, times are also given as the ratio of the module's median
+// to the reference's
+int print_result(const struct config* config, const struct result* result,
+	size_t list_len, const struct summary* reference)
+{
+	int status;
+	struct summary summary;
+	double throughput = 0;
+	size_t len = result->samples.len;
+	const struct module* module = &result->module;
+	const struct clock_source* clock = &config->clock;
+
+	if (result->histogram) {
+		len = result->histogram->len;
+		histogram_summary(&summary, result->histogram);
+	} else {
+		summary_compute(&summary, &result->samples);
 	}
 
-	// clear any potential dlerrors
-	dlerror();
-
-	// load all the modules
-	for (i = 0; i < argc - 1; ++i) {
-		status = module_init(&results[i].module, argv[i + 1]);
-		if (status < 0) {
-			fprintf(stderr,
-				"failed to load module: %s\n", argv[i + 1]);
+	if (result->elapsed > 0)
+		throughput = (len * 1e9) / clock_to_ns(clock, result->elapsed);
+
+	printf("%s,%s,%zu,%zu,%zu,%zu,%.1f,%.1f,%zu,%zu,%zu,%zu,%zu,%zu,%.0f",
+		module->name, module->author, len, result->tally.tested - len,
+		result->tally.incorrect, result->tally.timeouts,
+		clock_to_ns_f(clock, summary.average),
+		clock_to_ns_f(clock, summary.stdev),
+		clock_to_ns(clock, summary.median),
+		clock_to_ns(clock, summary.min),
+		clock_to_ns(clock, summary.max),
+		clock_to_ns(clock, summary.p90),
+		clock_to_ns(clock, summary.p99),
+		clock_to_ns(clock, summary.p999), throughput);
+
+	if (reference && reference->median > 0 && len > 0)
+		printf(",%.2f", (double)summary.median / reference->median);
+	else if (reference)
+		putchar(',');
+
+	if (reference)
+		printf(",%zu", result->tally.divergent);
+
+	if (config->cold && result->cold->len > 0)
+		printf(",%zu,%zu", clock_to_ns(clock,
+				histogram_quantile(result->cold, 0.5)),
+			clock_to_ns(clock,
+				histogram_quantile(result->cold, 0.99)));
+	else if (config->cold)
+		fputs(",,", stdout);
+
+	if (config->buckets) {
+		status = print_buckets(config, result, list_len);
+		if (status < 0)
 			return status;
-		}
-
-		results[i].data = (uint64_t*)results
-			+ (sizeof(struct result) * (argc - 1))
-			+ (i * (sizeof(uint64_t) * list_len));
 	}
 
-	// test every puzzle with every module
-	for (node = list; node != NULL; node = node->next) {
-		for (i = 0; i < (argc - 1); ++i) {
-			uint64_t duration;
-			status = test(&results[i].module, node->puzzle,
-				&duration);
-			if (status < 0) {
-				continue;
-			}
+	if (config->perf)
+		print_counters(result);
 
-			status = insert(
-				results[i].data, results[i].successes,
-				list_len, duration);
-			if (status < 0) {
-				fputs("failed to insert stat\n", stderr);
-				return status;
-			}
+	if (config->effort)
+		print_effort(config, result);
 
-			results[i].successes++;
-		}
+	putchar('\n');
+	return 0;
+}
+
+// a second table after a blank line, with a row for every pair of modules,
+// the reference first if there is one
+int print_comparisons(const struct config* config,
+	const struct result* reference, const struct result* results,
+	size_t modules, size_t list_len)
+{
+	int status = 0, i, j, first = config->reference ? -1 : 0;
+	struct rng rng;
+	struct verdict verdict;
+	struct comparison* comparison;
+	const struct result *a, *b;
+
+	comparison = malloc(sizeof(*comparison));
+	if (!comparison) {
+		fputs("failed to allocate comparison\n", stderr);
+		return -ENOMEM;
 	}
 
-	// print statistics
-	printf("name,author,success,fail,average,stdev,median,min,max\n");
-
-	for (i = 0; i < argc - 1; ++i) {
-		uint64_t average, stdev, median, min, max;
-		uint64_t* data = results[i].data;
-		size_t len = results[i].successes;
-		size_t incorrect = results[i].incorrect;
-		struct module* module = &results[i].module;
-
-		average = 0;
-		stdev = 0;
-		median = 0;
-		min = 0;
-		max = 0;
-
-		if (len > 0) {
-			min = data[0];
-			max = data[len - 1];
-			median = data[len / 2];
-
-			for (j = 0; j < len; ++j)
-				average += data[j];
-
-			average = average / len;
-
-			if (len > 1) {
-				for (j = 0; j < len; ++j) {
-					uint64_t diff = data[j] > average
-						? data[j] - average
-						: average - data[j];
-					stdev += diff * diff;
-				}
-				stdev /= len - 1;
-				stdev = sqrt(stdev);
-			}
-		}
+	rng_seed(&rng, config->seed, UINT64_MAX);
+	printf("\na,b,pairs,wins,losses,mean_difference,median_speedup,"
+		"median_low,median_high,geomean_speedup,p_value\n");
 
-		printf("%s,%s,%zu,%zu,%zu,%zu,%zu,%zu,%zu\n", module->name,
-			module->author, len, list_len - len, average, stdev,
-			median, min, max);
+	for (i = first; i < (int)modules && status == 0; ++i) {
+		a = i < 0 ? reference : &results[i];
+		for (j = i + 1; j < (int)modules && status == 0; ++j) {
+			b = &results[j];
+			status = compare_results(comparison, a, b, list_len,
+				&rng, &verdict);
+			if (status < 0)
+				break;
+
+			printf("%s,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64
+				",%.1f,%.4f,%.4f,%.4f,%.4f,%.3g\n",
+				a->module.name, b->module.name, verdict.pairs,
+				verdict.wins, verdict.losses,
+				clock_to_ns_f(&config->clock,
+					verdict.mean_difference),
+				verdict.median, verdict.low, verdict.high,
+				verdict.geomean, verdict.p_value);
+		}
 	}
 
-	return 0;
+	free(comparison);
+	return status;
 }
 
-// valid strings are less than 80 characters long, and contain no newlines or
-// commas
+void usage(const char* prog)
+{
+	fprintf(stderr,
+		"usage: %s [options] module.so... < puzzles.txt\n"
+		"\n"
+		"  -t, --threads N  split the puzzles across N pinned workers\n"
+		"  -c, --clock CLK  time solves with process, thread,\n"
+		"                   monotonic-raw or tsc (default: process,\n"
+		"                   or thread with more than one worker)\n"
+		"  -b, --batch N    puzzles per solve_batch call, 0 to always\n"
+		"                   use solve (default: 16)\n"
+		"  -w, --warmup K   untimed solves before timing each puzzle\n"
+		"  -r, --repeat R   timed solves of each puzzle (default: 1),\n"
+		"                   every one of which is verified\n"
+		"      --reduce FN  min or median of the repeats is recorded\n"
+		"                   (default: min)\n"
+		"      --schedule S in-order, shuffle to run the modules in a\n"
+		"                   random order for every puzzle, or blocked\n"
+		"                   to run all puzzles against one module\n"
+		"                   before the next (default: in-order)\n"
+		"  -s, --seed N     seed for the random choices of a run\n"
+		"  -i, --isolate    run each module in a process of its own\n"
+		"      --timeout MS give up on a solve that takes longer than\n"
+		"                   MS milliseconds, killing the module's\n"
+		"                   process under --isolate\n"
+		"      --budget MS  stop testing once the run has taken MS\n"
+		"                   milliseconds\n"
+		"      --stable CPU pin to CPU under SCHED_FIFO with memory\n"
+		"                   locked, and record the cpu's frequency\n"
+		"                   settings\n"
+		"  -p, --perf       count cycles, instructions, branch and\n"
+		"                   cache misses of every solve\n"
+		"      --cold SIZE  also time a solve of every puzzle after\n"
+		"                   evicting the caches with a SIZE byte\n"
+		"                   buffer (K, M or G suffixed)\n"
+		"      --hog N      run N threads sweeping memory for the\n"
+		"                   whole run\n"
+		"      --max-incorrect N\n"
+		"                   stop testing a module once it has given N\n"
+		"                   wrong answers\n"
+		"      --failures F write every wrong answer, failed solve\n"
+		"                   and divergence from the reference to F\n"
+		"      --effort     report the search effort of modules that\n"
+		"                   export solver_stats, with the time per\n"
+		"                   node\n"
+		"  -e, --export F   write the outcome and duration of every\n"
+		"                   puzzle against every module to F\n"
+		"      --reference  solve the puzzles with the built-in\n"
+		"                   solver first, to check they have a unique\n"
+		"                   solution, and as a baseline for the\n"
+		"                   modules\n"
+		"      --lockstep   also solve the puzzles with the built-in\n"
+		"                   vector solver, as a throughput ceiling\n"
+		"      --dedup      drop puzzles equivalent to an earlier one\n"
+		"                   under relabelling, permutation and\n"
+		"                   transposition\n"
+		"      --compare    compare every pair of modules puzzle by\n"
+		"                   puzzle, with confidence intervals and a\n"
+		"                   significance test\n"
+		"      --generate N generate N puzzles with a unique solution\n"
+		"                   instead of reading them from stdin\n"
+		"      --givens K   generate puzzles with K givens, at least\n"
+		"                   22 (default: as few as possible)\n"
+		"      --level L    generate easy, medium, hard or extreme\n"
+		"                   puzzles only\n"
+		"      --output F   write the generated puzzles to F, one per\n"
+		"                   line, and with no modules stop there\n"
+		"  -d, --difficulty bucket the puzzles by how hard they are,\n"
+		"                   with statistics for each bucket\n"
+		"  -m, --stream     test puzzles as they are read, and print\n"
+		"                   statistics as they go\n"
+		"      --every N    print stream statistics every N puzzles\n"
+		"      --interval MS\n"
+		"                   print stream statistics every MS\n"
+		"                   milliseconds (default: 1000)\n"
+		"      --daemon P   load the puzzles once, then run the\n"
+		"                   modules named by each connection to the\n"
+		"                   unix socket P\n"
+		"      --coordinator PORT\n"
+		"                   hand shards of the puzzles to workers\n"
+		"                   connecting to PORT, and report on them\n"
+		"                   all together\n"
+		"      --worker HOST:PORT\n"
+		"                   test shards handed out by the coordinator\n"
+		"                   at HOST:PORT\n"
+		"      --shard N    hand out N puzzles at a time (default:\n"
+		"                   262144)\n"
+		"  -h, --help       print this message\n",
+		prog);
+}
 
-bool strlen_less_than(const char* str, size_t max)
+int main(int argc, char* argv[])
 {
-	int i;
+	int status, opt, i;
+	size_t list_len, n, modules, timeout_ms, budget_ms = 0;
+	size_t duplicates = 0, stable_cpu, shard_size = SHARD_DEFAULT_SIZE;
+	size_t hogs = 0;
+	struct hog hog;
+	bool stable = false, lockstep = false;
+	const char* lockstep_target = NULL;
+	const char* output = NULL;
+	const char* daemon_path = NULL;
+	const char* coordinator = NULL;
+	const char* failures = NULL;
+	const char* worker = NULL;
+	char** filenames;
+	struct generator generator = { .level = -1 };
+	bool seeded = false;
+	char* end;
+	const char* clock_name = NULL;
+	struct config config = {
+		.threads = 1,
+		.batch = DEFAULT_BATCH_SIZE,
+		.repeat = 1,
+		.reduce = REDUCE_MIN,
+	};
+	struct clock_source* clock = &config.clock;
+	struct corpus corpus;
+	struct result* results;
+	struct result reference;
+	struct reference ground_truth;
+	struct result ceiling;
+	struct summary baseline;
+	struct bucket_stats bucket_stats[BUCKETS];
+	struct environment environment;
+	uint8_t* buckets;
+
+	while ((opt = getopt_long(argc, argv, "t:c:b:w:r:s:ipe:dmh", options, NULL)) != -1) {
+		switch (opt) {
+		case 't':
+			if (parse_count(optarg, &config.threads, 1,
+				"thread count") < 0)
+				return -1;
+			break;
+		case 'c':
+			clock_name = optarg;
+			break;
+		case 'b':
+			if (parse_count(optarg, &config.batch, 0, "batch size")
+				< 0)
+				return -1;
+			break;
+		case 'w':
+			if (parse_count(optarg, &config.warmup, 0,
+				"warmup count") < 0)
+				return -1;
+			break;
+		case 'r':
+			if (parse_count(optarg, &config.repeat, 1,
+				"repeat count") < 0)
+				return -1;
+			break;
+		case 'R':
+			if (strcmp(optarg, "min") == 0) {
+				config.reduce = REDUCE_MIN;
+			} else if (strcmp(optarg, "median") == 0) {
+				config.reduce = REDUCE_MEDIAN;
+			} else {
+				fprintf(stderr, "invalid reduction: %s\n",
+					optarg);
+				return -1;
+			}
+			break;
+		case 'S':
+			if (strcmp(optarg, "in-order") == 0) {
+				config.schedule = SCHEDULE_IN_ORDER;
+			} else if (strcmp(optarg, "shuffle") == 0) {
+				config.schedule = SCHEDULE_SHUFFLE;
+			} else if (strcmp(optarg, "blocked") == 0) {
+				config.schedule = SCHEDULE_BLOCKED;
+			} else {
+				fprintf(stderr, "invalid schedule: %s\n",
+					optarg);
+				return -1;
+			}
+			break;
+		case 's':
+			config.seed = strtoull(optarg, &end, 0);
+			if (*optarg == '\0' || *end != '\0') {
+				fprintf(stderr, "invalid seed: %s\n", optarg);
+				return -1;
+			}
+			seeded = true;
+			break;
+		case 'i':
+			config.isolate = true;
+			break;
+		case 'p':
+			config.perf = true;
+			break;
+		case 'E':
+			config.effort = true;
+			break;
+		case 'M':
+			if (parse_count(optarg, &config.max_incorrect, 1,
+				"incorrect count") < 0)
+				return -1;
+			break;
+		case 'A':
+			failures = optarg;
+			break;
+		case 'Y':
+			if (parse_size(optarg, &config.cold, PRESSURE_MIN_SIZE,
+				"eviction size") < 0)
+				return -1;
+			break;
+		case 'H':
+			if (parse_count(optarg, &hogs, 1, "hog count") < 0)
+				return -1;
+			break;
+		case 'e':
+			config.export = optarg;
+			break;
+		case 'F':
+			config.reference = true;
+			break;
+		case 'J':
+			lockstep = true;
+			break;
+		case 'D':
+			config.dedup = true;
+			break;
+		case 'd':
+			config.difficulty = true;
+			break;
+		case 'm':
+			config.stream = true;
+			break;
+		case 'N':
+			if (parse_count(optarg, &config.every, 1,
+				"puzzle count") < 0)
+				return -1;
+			break;
+		case 'I':
+			if (parse_count(optarg, &config.interval, 1,
+				"interval") < 0)
+				return -1;
+			break;
+		case 'T':
+			if (parse_count(optarg, &timeout_ms, 1, "timeout") < 0)
+				return -1;
 
-	for (i = 0; i < max; ++i)
-		if (str[i] == '\0')
-			return true;
+			config.timeout = timeout_ms * 1000000;
+			break;
+		case 'B':
+			if (parse_count(optarg, &budget_ms, 1, "budget") < 0)
+				return -1;
 
-	return false;
-}
+			config.budget = budget_ms * 1000000;
+			break;
+		case 'C':
+			config.compare = true;
+			break;
+		case 'G':
+			if (parse_count(optarg, &generator.count, 1,
+				"puzzle count") < 0)
+				return -1;
+			break;
+		case 'K':
+			if (parse_count(optarg, &generator.givens,
+				GENERATE_LOW_GIVENS, "given count") < 0)
+				return -1;
 
-bool valid_string(const char* str)
-{
-	int i;
+			if (generator.givens > SUDOKU_SIZE) {
+				fprintf(stderr, "invalid given count: %s\n",
+					optarg);
+				return -1;
+			}
+			break;
+		case 'L':
+			for (i = 0; i < BUCKETS; ++i)
+				if (strcmp(optarg, bucket_names[i]) == 0)
+					break;
+
+			if (i == BUCKETS) {
+				fprintf(stderr, "invalid level: %s\n", optarg);
+				return -1;
+			}
+
+			generator.level = i;
+			break;
+		case 'O':
+			output = optarg;
+			break;
+		case 'U':
+			daemon_path = optarg;
+			break;
+		case 'X':
+			coordinator = optarg;
+			break;
+		case 'W':
+			worker = optarg;
+			break;
+		case 'Z':
+			if (parse_count(optarg, &shard_size, 1, "shard size")
+				< 0)
+				return -1;
+			break;
+		case 'P':
+			if (parse_count(optarg, &stable_cpu, 0, "cpu") < 0)
+				return -1;
 
-	if (!strlen_less_than(str, 80)) {
-		printf("strlen not less than\n");
-		return false;
+			stable = true;
+			break;
+		case 'h':
+			usage(argv[0]);
+			return 0;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
 	}
 
-	return strpbrk(str, ",") == NULL;
-}
+	if ((output || generator.givens > 0 || generator.level >= 0)
+		&& generator.count == 0) {
+		fputs("--output, --givens and --level need --generate\n",
+			stderr);
+		return -1;
+	}
 
-int module_init(struct module* module, const char* filename)
-{
-	char *error;
+	// a corpus can be generated just to write it out
+	modules = argc - optind;
+	filenames = &argv[optind];
+	if (daemon_path && (modules > 0 || config.stream || output)) {
+		fputs("--daemon takes its modules from its clients\n", stderr);
+		return -1;
+	}
 
-	module->handle = dlopen(filename, RTLD_NOW | RTLD_LOCAL);
-	if (!module->handle)
+	if (modules < 1 && !output && !daemon_path) {
+		fputs("no modules\n", stderr);
 		return -1;
+	}
 
-	module->name = *(char**)dlsym(module->handle, "name");
-	error = dlerror();
-	if (error != NULL) {
-		fprintf(stderr, "%s\n", error);
+	if (config.isolate && config.threads > 1) {
+		fputs("--isolate and --threads can't be combined\n", stderr);
 		return -1;
 	}
 
-	module->author = *(char**)dlsym(module->handle, "author");
-	error = dlerror();
-	if (error != NULL) {
-		fprintf(stderr, "%s\n", error);
+	if (stable && config.threads > 1) {
+		fputs("--stable and --threads can't be combined\n", stderr);
 		return -1;
 	}
 
-	module->solve = dlsym(module->handle, "solve");
-	error = dlerror();
-	if (error != NULL) {
-		fprintf(stderr, "%s\n", error);
+	// hogs would inherit the stable cpu and SCHED_FIFO, and starve the
+	// module they're meant to compete with
+	if (stable && hogs > 0) {
+		fputs("--stable and --hog can't be combined\n", stderr);
 		return -1;
 	}
 
-	if (!valid_string(module->name)) {
-		fprintf(stderr, "invalid 'name' string from %s\n", filename);
+	// a stream is tested on one thread, and never held as a whole
+	if (config.stream && (config.isolate || config.threads > 1
+		|| config.perf || config.effort || config.export
+		|| config.reference || config.dedup || config.difficulty
+		|| config.compare || lockstep || generator.count > 0)) {
+		fputs("--stream only combines with the timing options\n",
+			stderr);
 		return -1;
 	}
 
-	if (!valid_string(module->author)) {
-		fprintf(stderr, "invalid 'author' string from %s\n", filename);
+	// only the workers run the modules, and the coordinator is the one that
+	// knows the settings they run them with
+	if ((coordinator || worker) && (config.isolate || config.budget
+		|| config.export || config.reference || config.dedup
+		|| config.difficulty || config.compare || config.stream
+		|| config.max_incorrect || failures || lockstep
+		|| generator.count > 0 || daemon_path)) {
+		fputs("--coordinator and --worker only combine with the timing "
+			"options\n", stderr);
 		return -1;
 	}
 
-	return 0;
-}
+	// the cold solves are only kept in process, in the clock's own ticks
+	if (config.cold && (config.isolate || config.stream || coordinator
+		|| worker)) {
+		fputs("--cold can't be combined with --isolate, --stream or "
+			"sharding\n", stderr);
+		return -1;
+	}
 
-int check(const int* puzzle)
-{
-	static const iterator_t iterators[] = {
-		row_iterator,
-		col_iterator,
-		cell_iterator
-	};
+	if (coordinator && (worker || stable || hogs > 0)) {
+		fputs("--coordinator runs no modules of its own\n", stderr);
+		return -1;
+	}
 
-	int status, i, j;
+	// workers report in nanoseconds, whatever clock they time with
+	if (coordinator)
+		clock_name = "monotonic-raw";
+	else if (!clock_name)
+		clock_name = config.threads > 1 || hogs > 0 ? "thread"
+			: "process";
+	else if ((config.threads > 1 || hogs > 0)
+		&& strcmp(clock_name, "process") == 0)
+		fputs("warning: process clock samples include every worker "
+			"and hog\n", stderr);
+
+	if (!seeded) {
+		struct timespec now;
+
+		clock_gettime(CLOCK_REALTIME, &now);
+		config.seed = ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec
+			+ getpid();
+	}
 
-	for (i = 0; i < SUDOKU_SIZE; ++i)
-		if (puzzle[i] < 0 || puzzle[i] > 9)
-			return -2;
+	// the clock's overhead is measured on the cpu the run will use
+	if (stable) {
+		status = stable_enter(&environment, stable_cpu);
+		if (status < 0)
+			return status;
+	}
 
-	for (i = 0; i < SUDOKU_AXIS_SIZE; ++i) {
-		for (j = 0; j < ARRAY_SIZE(iterators); ++j) {
-			status = check_iterator(puzzle, iterators[j], i);
-			if (status < 0)
-				return status;
-		}
+	status = clock_source_init(clock, clock_name);
+	if (status < 0)
+		return status;
+
+	if (failures) {
+		status = failures_open(&config, failures);
+		if (status < 0)
+			return status;
 	}
 
-	return 0;
-}
+	// the hogs keep going until the run is over, or the process exits
+	if (hogs > 0) {
+		status = hog_start(&hog, hogs);
+		if (status < 0)
+			return status;
+	}
 
-int cross_check(const int* puzzle, int* solution)
-{
-	int status, i;
+	if (config.stream) {
+		if (stable)
+			stable_print(&environment, clock);
 
-	for (i = 0; i < SUDOKU_SIZE; ++i) {
-		if (solution[i] < 1 || solution[i] > 9)
-			return -1;
+		if (config.every == 0 && config.interval == 0)
+			config.interval = DEFAULT_STREAM_INTERVAL;
 
-		if (puzzle[i] > 0 && puzzle[i] != solution[i])
-			return -1;
+		return stream_run(&config, STDIN_FILENO, filenames,
+			modules);
 	}
 
-	return check(solution);
-}
+	if (generator.count > 0) {
+		generator.threads = config.threads;
+		generator.seed = config.seed;
+		status = generate_corpus(&generator, &corpus);
+		if (status < 0)
+			return status;
 
-int test(const struct module* module, int* puzzle, uint64_t* duration)
-{
-	int status;
-	struct timespec start, finish;
-	int solution[SUDOKU_SIZE];
+		if (output) {
+			status = generate_write(&corpus, output);
+			if (status < 0 || modules == 0)
+				return status;
+		}
+	} else {
+		status = corpus_load(&corpus, STDIN_FILENO);
+		if (status < 0)
+			return status;
+	}
 
-	memcpy(solution, puzzle, sizeof(solution));
+	if (corpus.len == 0) {
+		fputs("no puzzles\n", stderr);
+		return -1;
+	}
 
-	status = clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &start);
-	if (status < 0)
-		return status;
+	for (n = 0; n < corpus.len; ++n) {
+		status = check(corpus_get(&corpus, n));
+		if (status < 0) {
+			fputs("invalid puzzle\n", stderr);
+			return status;
+		}
+	}
 
-	status = module->solve(solution);
-	if (status < 0) {
-		return status;
+	// a worker prints nothing, its results go to the coordinator
+	if (worker)
+		return shard_work(&config, &corpus, filenames, modules,
+			worker);
+
+	if (config.dedup) {
+		status = canon_dedup(&corpus, &duplicates);
+		if (status < 0)
+			return status;
 	}
 
-	status = clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &finish);
-	if (status < 0)
-		return status;
+	list_len = corpus.len;
 
-	status = cross_check(puzzle, solution);
-	if (status < 0)
-		return status;
+	if (config.difficulty) {
+		buckets = malloc(list_len);
+		if (!buckets) {
+			fputs("failed to allocate buckets\n", stderr);
+			return -ENOMEM;
+		}
 
-	*duration = timespec_to_us(&finish) - timespec_to_us(&start);
+		difficulty_classify(&corpus, buckets, bucket_stats);
+		config.buckets = buckets;
+	}
 
-	return 0;
-}
+	if (config.reference) {
+		status = reference_run(&config, &corpus, &reference,
+			&ground_truth);
+		if (status < 0)
+			return status;
 
-void list_append(struct list_node **list, struct list_node* node)
-{
-	struct list_node *cursor = *list;
+		// from here on solutions are compared against the reference
+		config.solutions = ground_truth.solutions;
+		config.ambiguous = ground_truth.ambiguity;
+	}
 
-	node->next = NULL;
-	if (*list == NULL) {
-		*list = node;
-		return;
+	// the ceiling is measured in process even under --isolate, it has
+	// nothing to crash
+	if (lockstep) {
+		lockstep_target = lockstep_select();
+		status = lockstep_run(&config, &corpus, &ceiling);
+		if (status < 0)
+			return status;
 	}
 
-	while (cursor->next != NULL)
-		cursor = cursor->next;
+	// the daemon only returns to serve a request, the rest of the run is
+	// the same as for modules given on the command line
+	if (daemon_path) {
+		status = daemon_serve(daemon_path, &filenames, &modules);
+		if (status < 0)
+			return status;
+	}
 
-	cursor->next = node;
-}
+	// every module's samples get an allocation of their own, none of
+	// which share a cache line
+	results = aligned_alloc(CACHE_LINE_SIZE,
+		sizeof(struct result) * modules);
+	if (!results) {
+		fputs("failed to allocate results\n", stderr);
+		return -ENOMEM;
+	}
 
-size_t list_size(const struct list_node* list)
-{
-	size_t size = 0;
+	memset(results, 0, sizeof(struct result) * modules);
+	for (i = 0; config.cold && i < modules; ++i) {
+		results[i].cold = malloc(sizeof(struct histogram));
+		if (!results[i].cold) {
+			fputs("failed to allocate results\n", stderr);
+			return -ENOMEM;
+		}
 
-	for (; list != NULL; list = list->next)
-		size++;
+		histogram_reset(results[i].cold);
+	}
 
-	return size;
-}
+	for (i = 0; coordinator && i < modules; ++i) {
+		results[i].histogram = malloc(sizeof(struct histogram));
+		if (!results[i].histogram) {
+			fputs("failed to allocate results\n", stderr);
+			return -ENOMEM;
+		}
 
-int check_iterator(const int* puzzle, int (*iterator)(int, int), int i)
-{
-	int j;
-	bool flags[SUDOKU_AXIS_SIZE] = {false};
+		histogram_reset(results[i].histogram);
+	}
 
-	for (j = 0; j < SUDOKU_AXIS_SIZE; ++j) {
-		int value = puzzle[iterator(i, j)];
+	for (i = 0; !coordinator && i < modules; ++i) {
+		results[i].samples.data = aligned_alloc(CACHE_LINE_SIZE,
+			ALIGN_UP(sizeof(uint64_t) * list_len, CACHE_LINE_SIZE));
+		results[i].samples.cap = list_len;
+		if (!results[i].samples.data) {
+			fputs("failed to allocate results\n", stderr);
+			return -ENOMEM;
+		}
+	}
 
-		if (value > 0) {
-			if (flags[value - 1])
-				return -1;
-			else
-				flags[value - 1] = true;
+	if (config.export || config.difficulty || config.compare) {
+		status = results_columns(results, modules, list_len);
+		if (status < 0)
+			return status;
+	}
+
+	// nothing the run writes to should fault on its first touch
+	for (i = 0; stable && i < modules; ++i) {
+		stable_prefault(results[i].samples.data,
+			sizeof(uint64_t) * list_len);
+		if (results[i].durations) {
+			stable_prefault(results[i].durations,
+				sizeof(uint64_t) * list_len);
+			stable_prefault(results[i].outcomes, list_len);
 		}
 	}
 
-	return 0;
-}
+	if (stable)
+		stable_prefault(corpus.puzzles, SUDOKU_SIZE * list_len);
 
-int row_iterator(int row, int col)
-{
-	return (9 * row) + col;
-}
+	// test every puzzle with every module
+	if (coordinator)
+		status = shard_coordinate(&config, &corpus, results, filenames,
+			modules, coordinator, shard_size);
+	else if (config.isolate)
+		status = isolate_run(&config, &corpus, results, filenames,
+			modules);
+	else
+		status = run_in_process(&config, &corpus, results,
+			filenames, modules);
 
-int col_iterator(int col, int row)
-{
-	return row_iterator(row, col);
-}
+	if (status < 0)
+		return status;
 
-int cell_iterator(int cell, int pos)
-{
-	return row_iterator(
-			((cell / 3) * 3) + (pos / 3),
-			((cell % 3) * 3) + (pos % 3));
-}
+	if (hogs > 0)
+		hog_stop(&hog);
 
-int insert(
-	uint64_t *arr, size_t len, size_t max, uint64_t val)
-{
-	size_t cursor, div;
+	if (config.export) {
+		status = export_write(config.export, &config, results, modules,
+			list_len);
+		if (status < 0)
+			return status;
+	}
 
-	if (len >= max)
-		return -ERANGE;
+	// print statistics
+	if (stable)
+		stable_print(&environment, clock);
+
+	if (config.schedule == SCHEDULE_SHUFFLE)
+		printf("# schedule: shuffle\n");
+	else if (config.schedule == SCHEDULE_BLOCKED)
+		printf("# schedule: blocked\n");
+
+	if (generator.count > 0)
+		printf("# generated: %zu\n", generator.count);
+
+	// the shuffle, the bootstrap and the generator all draw from the seed
+	if (config.schedule == SCHEDULE_SHUFFLE || config.compare
+		|| generator.count > 0)
+		printf("# seed: %" PRIu64 "\n", config.seed);
+
+	if (config.dedup)
+		printf("# duplicates: %zu\n", duplicates);
+
+	// puzzles the budget didn't reach are neither successes nor failures
+	if (config.budget > 0)
+		printf("# budget: %zu ms\n# puzzles: %zu\n", budget_ms,
+			list_len);
+
+	// modules cut short by --max-incorrect weren't tested on the rest
+	for (i = 0; config.max_incorrect > 0 && i < modules; ++i)
+		if (results[i].tally.incorrect >= config.max_incorrect)
+			printf("# stopped: %s\n", results[i].module.name);
+
+	for (i = 0; config.difficulty && i < BUCKETS; ++i) {
+		struct bucket_stats* bucket = &bucket_stats[i];
+		double puzzles = bucket->puzzles ? bucket->puzzles : 1;
+
+		printf("# %s: %zu puzzles, %.1f givens, %.1f singles, "
+			"%.1f nodes\n", bucket_names[i], bucket->puzzles,
+			bucket->givens / puzzles, bucket->singles / puzzles,
+			bucket->nodes / puzzles);
+	}
 
-	cursor = len / 2;
-	for (div = len / 4; div > 0; div /= 2)
-		cursor = val > arr[cursor] ? cursor + div : cursor - div;
+	if (config.reference) {
+		printf("# unsolvable: %zu\n# ambiguous: %zu\n",
+			ground_truth.unsolvable, ground_truth.ambiguous);
+		summary_compute(&baseline, &reference.samples);
+	}
 
-	memmove(&arr[cursor + 1], &arr[cursor],
-		(len - cursor) * sizeof(uint64_t));
-	arr[cursor] = val;
-	return 0;
+	if (lockstep)
+		printf("# lockstep: %s\n", lockstep_target);
+
+	printf("name,author,success,fail,incorrect,timeout,average,stdev,"
+		"median,min,max,p90,p99,p999,throughput");
+	if (config.reference)
+		printf(",relative,divergent");
+	if (config.cold)
+		printf(",cold_median,cold_p99");
+	for (i = 0; config.difficulty && i < BUCKETS; ++i)
+		printf(",%s_success,%s_median,%s_p99", bucket_names[i],
+			bucket_names[i], bucket_names[i]);
+	if (config.perf)
+		printf(",cycles,instructions,ipc,branch_misses,l1d_misses,"
+			"llc_misses");
+	if (config.effort)
+		printf(",nodes,guesses,backtracks,propagations,ns_per_node");
+
+	putchar('\n');
+
+	if (config.reference) {
+		status = print_result(&config, &reference, list_len, &baseline);
+		if (status < 0)
+			return status;
+	}
 
-}
+	if (lockstep) {
+		status = print_result(&config, &ceiling, list_len,
+			config.reference ? &baseline : NULL);
+		if (status < 0)
+			return status;
+	}
 
-uint64_t timespec_to_us(struct timespec* val)
-{
-	return (val->tv_sec * 1000000) + (val->tv_nsec / 1000);
+	for (i = 0; i < modules; ++i) {
+		status = print_result(&config, &results[i], list_len,
+			config.reference ? &baseline : NULL);
+		if (status < 0)
+			return status;
+	}
+
+	if (config.compare)
+		return print_comparisons(&config, &reference, results, modules,
+			list_len);
+
+	return 0;
 }
@@ -0,0 +1,115 @@
+// Sudoku Master Module Loader
+//
+// Author: Matthew Knight
+// File Name: module.c
+// Date: 2026-10-14
+//
+// Modules are shared objects loaded with dlopen. See README.md for the symbols
+// they are required to, or may optionally, export.
+
+#include <dlfcn.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "module.h"
+
+// valid strings are less than 80 characters long, and contain no newlines or
+// commas
+
+bool strlen_less_than(const char* str, size_t max)
+{
+	int i;
+
+	for (i = 0; i < max; ++i)
+		if (str[i] == '\0')
+			return true;
+
+	return false;
+}
+
+bool valid_string(const char* str)
+{
+	int i;
+
+	if (!strlen_less_than(str, 80)) {
+		printf("strlen not less than\n");
+		return false;
+	}
+
+	return strpbrk(str, ",") == NULL;
+}
+
+// optional symbols are just left NULL when the module doesn't export them
+static void* module_get_optional(void* handle, const char* sym)
+{
+	void* ret = dlsym(handle, sym);
+
+	dlerror();
+	return ret;
+}
+
+int module_init(struct module* module, const char* filename)
+{
+	char *error;
+
+	module->handle = dlopen(filename, RTLD_NOW | RTLD_LOCAL);
+	if (!module->handle)
+		return -1;
+
+	module->name = *(char**)dlsym(module->handle, "name");
+	error = dlerror();
+	if (error != NULL) {
+		fprintf(stderr, "%s\n", error);
+		return -1;
+	}
+
+	module->author = *(char**)dlsym(module->handle, "author");
+	error = dlerror();
+	if (error != NULL) {
+		fprintf(stderr, "%s\n", error);
+		return -1;
+	}
+
+	// either flavour of solve will do, a module exporting both is handed
+	// bytes
+	module->solve = module_get_optional(module->handle, "solve");
+	module->solve_u8 = module_get_optional(module->handle, "solve_u8");
+	if (!module->solve && !module->solve_u8) {
+		fprintf(stderr, "%s: no solve or solve_u8 symbol\n", filename);
+		return -1;
+	}
+
+	module->solve_batch = module_get_optional(module->handle,
+		"solve_batch");
+	module->solve_batch_u8 = module_get_optional(module->handle,
+		"solve_batch_u8");
+	module->stats = module_stats(module);
+
+	if (!valid_string(module->name)) {
+		fprintf(stderr, "invalid 'name' string from %s\n", filename);
+		return -1;
+	}
+
+	if (!valid_string(module->author)) {
+		fprintf(stderr, "invalid 'author' string from %s\n", filename);
+		return -1;
+	}
+
+	return 0;
+}
+
+bool module_batched(const struct module* module)
+{
+	return module->solve_batch || module->solve_batch_u8;
+}
+
+// the statistics of a thread local export live at a different address on
+// every thread, so each thread has to look them up for itself
+struct solver_stats* module_stats(const struct module* module)
+{
+	if (!module->handle)
+		return module->stats;
+
+	return module_get_optional(module->handle, "solver_stats");
+}
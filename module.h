@@ -0,0 +1,31 @@
+// Sudoku Master Module Loader
+//
+// Author: Matthew Knight
+// File Name: module.h
+// Date: 2026-10-14
+
+#ifndef MODULE_H
+#define MODULE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "solver_stats.h"
+
+struct module {
+    void* handle;
+    const char* name;
+    const char* author;
+    int (*solve)(int*);
+    int (*solve_batch)(int*, size_t);
+    int (*solve_u8)(uint8_t*);
+    int (*solve_batch_u8)(uint8_t*, size_t);
+    struct solver_stats* stats;
+};
+
+int module_init(struct module* module, const char* filename);
+bool module_batched(const struct module* module);
+struct solver_stats* module_stats(const struct module* module);
+
+#endif
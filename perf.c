@@ -0,0 +1,171 @@
+// Sudoku Master Hardware Counters
+//
+// Author: Matthew Knight
+// File Name: perf.c
+// Date: 2026-10-14
+//
+// Counters the cpu or hypervisor doesn't provide are left out of the group
+// rather than failing the run, as long as the cycle counter leading the group
+// can be opened.
+
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "perf.h"
+
+#define CACHE_MISS(cache) ((cache) \
+	| (PERF_COUNT_HW_CACHE_OP_READ << 8) \
+	| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct {
+	uint32_t type;
+	uint64_t config;
+} events[PERF_COUNTERS] = {
+	[PERF_CYCLES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+	[PERF_INSTRUCTIONS] = { PERF_TYPE_HARDWARE,
+		PERF_COUNT_HW_INSTRUCTIONS },
+	[PERF_BRANCH_MISSES] = { PERF_TYPE_HARDWARE,
+		PERF_COUNT_HW_BRANCH_MISSES },
+	[PERF_L1D_MISSES] = { PERF_TYPE_HW_CACHE,
+		CACHE_MISS(PERF_COUNT_HW_CACHE_L1D) },
+	[PERF_LLC_MISSES] = { PERF_TYPE_HW_CACHE,
+		CACHE_MISS(PERF_COUNT_HW_CACHE_LL) },
+};
+
+const char* const perf_names[PERF_COUNTERS] = {
+	[PERF_CYCLES] = "cycles",
+	[PERF_INSTRUCTIONS] = "instructions",
+	[PERF_BRANCH_MISSES] = "branch_misses",
+	[PERF_L1D_MISSES] = "l1d_misses",
+	[PERF_LLC_MISSES] = "llc_misses",
+};
+
+// the layout of a PERF_FORMAT_GROUP read
+struct perf_read {
+    uint64_t nr;
+    uint64_t values[PERF_COUNTERS];
+};
+
+static int perf_event_open(struct perf_event_attr* attr, int group)
+{
+	return syscall(SYS_perf_event_open, attr, 0, -1, group, 0);
+}
+
+// counts the calling thread, on whichever cpu it runs
+int perf_open(struct perf* perf)
+{
+	int i;
+	struct perf_event_attr attr;
+
+	memset(perf, 0, sizeof(*perf));
+	for (i = 0; i < PERF_COUNTERS; ++i) {
+		perf->fds[i] = -1;
+		perf->index[i] = -1;
+	}
+
+	for (i = 0; i < PERF_COUNTERS; ++i) {
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = events[i].type;
+		attr.config = events[i].config;
+		attr.read_format = PERF_FORMAT_GROUP;
+		attr.disabled = i == PERF_CYCLES;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		perf->fds[i] = perf_event_open(&attr, i == PERF_CYCLES
+			? -1 : perf->fds[PERF_CYCLES]);
+		if (perf->fds[i] < 0) {
+			if (i == PERF_CYCLES) {
+				fprintf(stderr, "failed to open perf counters: "
+					"%s\n", strerror(errno));
+				return -errno;
+			}
+
+			continue;
+		}
+
+		perf->index[i] = perf->opened++;
+	}
+
+	ioctl(perf->fds[PERF_CYCLES], PERF_EVENT_IOC_RESET,
+		PERF_IOC_FLAG_GROUP);
+	ioctl(perf->fds[PERF_CYCLES], PERF_EVENT_IOC_ENABLE,
+		PERF_IOC_FLAG_GROUP);
+	return 0;
+}
+
+void perf_close(struct perf* perf)
+{
+	int i;
+
+	for (i = PERF_COUNTERS - 1; i >= 0; --i)
+		if (perf->fds[i] >= 0)
+			close(perf->fds[i]);
+
+	memset(perf->fds, -1, sizeof(perf->fds));
+}
+
+// a mask of the counters that could be opened, by enum perf_counter
+unsigned perf_available(const struct perf* perf)
+{
+	int i;
+	unsigned mask = 0;
+
+	for (i = 0; i < PERF_COUNTERS; ++i)
+		if (perf->index[i] >= 0)
+			mask |= 1u << i;
+
+	return mask;
+}
+
+static void perf_read(const struct perf* perf, uint64_t* values)
+{
+	int i;
+	struct perf_read buf;
+
+	if (read(perf->fds[PERF_CYCLES], &buf, sizeof(buf)) < 0)
+		memset(&buf, 0, sizeof(buf));
+
+	for (i = 0; i < PERF_COUNTERS; ++i)
+		values[i] = perf->index[i] >= 0
+			? buf.values[perf->index[i]] : 0;
+}
+
+void perf_begin(struct perf* perf)
+{
+	perf_read(perf, perf->begin);
+}
+
+// adds the counts since perf_begin() to the running totals, for a call that
+// solved the given number of puzzles
+void perf_end(struct perf* perf, size_t solves)
+{
+	int i;
+	uint64_t end[PERF_COUNTERS];
+
+	perf_read(perf, end);
+	for (i = 0; i < PERF_COUNTERS; ++i)
+		perf->totals[i] += end[i] - perf->begin[i];
+
+	perf->solves += solves;
+}
+
+// moves the running totals into the caller's, so that they can be credited to
+// the module that was just tested
+void perf_drain(struct perf* perf, uint64_t* totals, uint64_t* solves)
+{
+	int i;
+
+	for (i = 0; i < PERF_COUNTERS; ++i)
+		totals[i] += perf->totals[i];
+
+	*solves += perf->solves;
+	memset(perf->totals, 0, sizeof(perf->totals));
+	perf->solves = 0;
+}
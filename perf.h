@@ -0,0 +1,44 @@
+// Sudoku Master Hardware Counters
+//
+// Author: Matthew Knight
+// File Name: perf.h
+// Date: 2026-10-14
+//
+// With --perf every worker opens a group of hardware counters on itself, and
+// the group is read immediately before and after each call into a module. Only
+// user space is counted, so the reads themselves don't show up in the counts.
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+enum perf_counter {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_COUNTERS,
+};
+
+struct perf {
+    int fds[PERF_COUNTERS];
+    int index[PERF_COUNTERS];
+    int opened;
+    uint64_t begin[PERF_COUNTERS];
+    uint64_t totals[PERF_COUNTERS];
+    uint64_t solves;
+};
+
+extern const char* const perf_names[PERF_COUNTERS];
+
+int perf_open(struct perf* perf);
+void perf_close(struct perf* perf);
+unsigned perf_available(const struct perf* perf);
+void perf_begin(struct perf* perf);
+void perf_end(struct perf* perf, size_t solves);
+void perf_drain(struct perf* perf, uint64_t* totals, uint64_t* solves);
+
+#endif
@@ -0,0 +1,119 @@
+// Sudoku Master Cache Pressure
+//
+// Author: Matthew Knight
+// File Name: pressure.c
+// Date: 2026-10-14
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pressure.h"
+#include "sudoku.h"
+
+int eviction_init(struct eviction* eviction, size_t size)
+{
+	eviction->size = ALIGN_UP(size, CACHE_LINE_SIZE);
+	eviction->buffer = aligned_alloc(CACHE_LINE_SIZE, eviction->size);
+	if (!eviction->buffer) {
+		fputs("failed to allocate eviction buffer\n", stderr);
+		return -ENOMEM;
+	}
+
+	memset(eviction->buffer, 0, eviction->size);
+	return 0;
+}
+
+void eviction_free(struct eviction* eviction)
+{
+	free(eviction->buffer);
+	eviction->buffer = NULL;
+}
+
+// every line is written rather than read, so that it's owned exclusively and
+// has to be written back again when it's evicted in turn
+void eviction_run(struct eviction* eviction)
+{
+	size_t i;
+	volatile uint8_t* buffer = eviction->buffer;
+
+	for (i = 0; i < eviction->size; i += CACHE_LINE_SIZE)
+		++buffer[i];
+}
+
+// a line aligned spot with room for len bytes
+void* eviction_place(struct eviction* eviction, struct rng* rng, size_t len)
+{
+	size_t lines = (eviction->size - ALIGN_UP(len, CACHE_LINE_SIZE))
+		/ CACHE_LINE_SIZE;
+
+	return eviction->buffer
+		+ (rng_below(rng, lines + 1) * CACHE_LINE_SIZE);
+}
+
+// half of the buffer is copied over the other half and back, which keeps a
+// read and a write stream going at once
+static void* hog_run(void* arg)
+{
+	struct hog_thread* thread = arg;
+	size_t half = PRESSURE_HOG_SIZE / 2;
+
+	while (!atomic_load_explicit(thread->stop, memory_order_relaxed)) {
+		memcpy(thread->buffer + half, thread->buffer, half);
+		memcpy(thread->buffer, thread->buffer + half, half);
+	}
+
+	return NULL;
+}
+
+int hog_start(struct hog* hog, size_t threads)
+{
+	int status;
+	struct hog_thread* thread;
+
+	hog->len = 0;
+	atomic_store(&hog->stop, false);
+	hog->threads = calloc(threads, sizeof(struct hog_thread));
+	if (!hog->threads) {
+		fputs("failed to allocate hogs\n", stderr);
+		return -ENOMEM;
+	}
+
+	for (; hog->len < threads; ++hog->len) {
+		thread = &hog->threads[hog->len];
+		thread->stop = &hog->stop;
+		thread->buffer = aligned_alloc(CACHE_LINE_SIZE,
+			PRESSURE_HOG_SIZE);
+		if (!thread->buffer) {
+			fputs("failed to allocate hogs\n", stderr);
+			hog_stop(hog);
+			return -ENOMEM;
+		}
+
+		memset(thread->buffer, 0, PRESSURE_HOG_SIZE);
+		status = pthread_create(&thread->thread, NULL, hog_run, thread);
+		if (status != 0) {
+			fputs("failed to start hog\n", stderr);
+			free(thread->buffer);
+			hog_stop(hog);
+			return -status;
+		}
+	}
+
+	return 0;
+}
+
+void hog_stop(struct hog* hog)
+{
+	size_t t;
+
+	atomic_store(&hog->stop, true);
+	for (t = 0; t < hog->len; ++t) {
+		pthread_join(hog->threads[t].thread, NULL);
+		free(hog->threads[t].buffer);
+	}
+
+	free(hog->threads);
+	hog->len = 0;
+}
@@ -0,0 +1,55 @@
+// Sudoku Master Cache Pressure
+//
+// Author: Matthew Knight
+// File Name: pressure.h
+// Date: 2026-10-14
+//
+// Two ways of taking away the warm caches a tight benchmark loop enjoys. With
+// --cold every worker owns an eviction buffer which it writes a byte of on
+// every cache line before each cold solve, pushing the module's code, tables
+// and stack out of every level the buffer is larger than. The grid of the cold
+// solve is then placed at a random line of the same buffer, so it's never at
+// an address the module has seen recently. With --hog, threads of their own
+// sweep large buffers for the whole run, competing for memory bandwidth and
+// for the last level cache.
+
+#ifndef PRESSURE_H
+#define PRESSURE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "random.h"
+
+#define PRESSURE_MIN_SIZE 4096
+#define PRESSURE_HOG_SIZE (64 << 20)
+
+struct eviction {
+    uint8_t* buffer;
+    size_t size;
+};
+
+struct hog_thread {
+    pthread_t thread;
+    const _Atomic bool* stop;
+    uint8_t* buffer;
+};
+
+struct hog {
+    struct hog_thread* threads;
+    size_t len;
+    _Atomic bool stop;
+};
+
+int eviction_init(struct eviction* eviction, size_t size);
+void eviction_free(struct eviction* eviction);
+void eviction_run(struct eviction* eviction);
+void* eviction_place(struct eviction* eviction, struct rng* rng, size_t len);
+
+int hog_start(struct hog* hog, size_t threads);
+void hog_stop(struct hog* hog);
+
+#endif
@@ -0,0 +1,63 @@
+// Sudoku Master Random Numbers
+//
+// Author: Matthew Knight
+// File Name: random.h
+// Date: 2026-10-14
+//
+// A small seeded xoshiro256** generator. Anything in the harness that makes a
+// random choice draws from one of these so that a run can be reproduced from
+// its seed.
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+struct rng {
+    uint64_t s[4];
+};
+
+static inline uint64_t splitmix64(uint64_t* x)
+{
+	uint64_t z = (*x += 0x9e3779b97f4a7c15);
+
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
+
+// streams seeded with the same seed but a different stream number are
+// independent, which gives each worker its own sequence
+static inline void rng_seed(struct rng* rng, uint64_t seed, uint64_t stream)
+{
+	int i;
+	uint64_t x = seed ^ splitmix64(&stream);
+
+	for (i = 0; i < 4; ++i)
+		rng->s[i] = splitmix64(&x);
+}
+
+static inline uint64_t rng_next(struct rng* rng)
+{
+	uint64_t* s = rng->s;
+	uint64_t result = s[1] * 5, t = s[1] << 17;
+
+	result = ((result << 7) | (result >> 57)) * 9;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+
+	return result;
+}
+
+// uniform in [0, n), using the multiply-shift reduction
+static inline uint64_t rng_below(struct rng* rng, uint64_t n)
+{
+	return (uint64_t)(((unsigned __int128)rng_next(rng) * n) >> 64);
+}
+
+#endif
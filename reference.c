@@ -0,0 +1,134 @@
+// Sudoku Master Reference
+//
+// Author: Matthew Knight
+// File Name: reference.c
+// Date: 2026-10-14
+//
+// The reference is wrapped up as a module on the byte ABI and driven by a
+// worker of its own on the calling thread, so it gets the same warmup,
+// repeats and counters as everything it's compared against.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "reference.h"
+#include "solver.h"
+
+// only ever solved on the thread running the reference
+static struct solver_stats reference_stats;
+
+int reference_solve(uint8_t* grid)
+{
+	return solver_solve_counted(grid, 1, &reference_stats) == 1 ? 0 : -1;
+}
+
+int reference_run(const struct config* config, const struct corpus* corpus,
+	struct result* result, struct reference* reference)
+{
+	int status, solutions;
+	size_t n;
+	uint64_t duration;
+	enum outcome outcome;
+	uint8_t grid[SUDOKU_SIZE];
+	struct worker worker;
+	struct arena arena;
+
+	memset(result, 0, sizeof(*result));
+	memset(reference, 0, sizeof(*reference));
+	result->module.name = REFERENCE_NAME;
+	result->module.author = REFERENCE_AUTHOR;
+	result->module.solve_u8 = reference_solve;
+	result->module.stats = &reference_stats;
+	result->samples.data = calloc(corpus->len, sizeof(uint64_t));
+	result->samples.cap = corpus->len;
+	if (config->difficulty || config->compare) {
+		status = results_columns(result, 1, corpus->len);
+		if (status < 0)
+			return status;
+	}
+
+	arena_init(&arena);
+	memset(&worker, 0, sizeof(worker));
+	worker.config = config;
+	worker.corpus = corpus;
+	worker.results = result;
+	worker.modules = 1;
+	worker.arenas = &arena;
+	worker.tallies = &result->tally;
+	worker.elapsed = &result->elapsed;
+	worker.counters = result->counters;
+	worker.counted = &result->counted;
+	worker.efforts = &result->effort;
+	if (config->effort)
+		worker.source = &reference_stats;
+	worker.repeats = calloc(config->repeat, sizeof(uint64_t));
+	reference->solutions = calloc(corpus->len, SUDOKU_SIZE);
+	reference->ambiguity = calloc(corpus->len, 1);
+	if (!result->samples.data || !worker.repeats || !reference->solutions
+		|| !reference->ambiguity) {
+		fputs("failed to allocate reference\n", stderr);
+		return -ENOMEM;
+	}
+
+	if (config->cold) {
+		result->cold = malloc(sizeof(struct histogram));
+		if (!result->cold) {
+			fputs("failed to allocate reference\n", stderr);
+			return -ENOMEM;
+		}
+
+		histogram_reset(result->cold);
+		worker.colds = result->cold;
+		status = eviction_init(&worker.eviction, config->cold);
+		if (status < 0)
+			return status;
+	}
+
+	if (config->perf) {
+		status = perf_open(&worker.perf);
+		if (status < 0)
+			return status;
+
+		result->available = perf_available(&worker.perf);
+	}
+
+	for (n = 0; n < corpus->len; ++n) {
+		memcpy(grid, corpus_get(corpus, n), SUDOKU_SIZE);
+		solutions = solver_solve(grid, 2);
+		if (solutions < 0) {
+			fputs("failed to run reference solver\n", stderr);
+			return solutions;
+		}
+
+		if (solutions == 0) {
+			++reference->unsolvable;
+		} else {
+			memcpy(&reference->solutions[n * SUDOKU_SIZE], grid,
+				SUDOKU_SIZE);
+			reference->ambiguity[n] = solutions > 1;
+			reference->ambiguous += solutions > 1;
+		}
+
+		if (config->cold)
+			worker_cold(&worker, 0, n);
+
+		outcome = worker_test(&worker, &result->module, n, &duration);
+		worker.elapsed[0] += duration;
+		worker_count(&worker, 0);
+
+		status = worker_record(&worker, 0, n, outcome, duration);
+		if (status < 0)
+			return status;
+	}
+
+	if (config->perf)
+		perf_close(&worker.perf);
+
+	free(worker.repeats);
+	eviction_free(&worker.eviction);
+	status = arena_merge(&(struct arena*){ &arena }, 1, &result->samples);
+	arena_free(&arena);
+	return status;
+}
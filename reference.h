@@ -0,0 +1,38 @@
+// Sudoku Master Reference
+//
+// Author: Matthew Knight
+// File Name: reference.h
+// Date: 2026-10-14
+//
+// With --reference the corpus is solved by the built-in solver before any
+// module runs. Every puzzle is searched for a second solution, and the
+// reference is timed exactly like a module, so that the modules' times can be
+// given relative to it.
+
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "corpus.h"
+#include "runner.h"
+
+#define REFERENCE_NAME "reference"
+#define REFERENCE_AUTHOR "sudoku-master"
+
+// solutions holds the solution of every puzzle that has one, and zeroes for
+// the rest. where a puzzle has several it's the first one the reference
+// found, and the puzzle is marked in ambiguity
+struct reference {
+    size_t unsolvable;
+    size_t ambiguous;
+    uint8_t* solutions;
+    uint8_t* ambiguity;
+};
+
+int reference_run(const struct config* config, const struct corpus* corpus,
+	struct result* result, struct reference* reference);
+int reference_solve(uint8_t* grid);
+
+#endif
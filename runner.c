@@ -0,0 +1,922 @@
+// Sudoku Master Runner
+//
+// Author: Matthew Knight
+// File Name: runner.c
+// Date: 2026-10-14
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+#include "runner.h"
+
+// the per puzzle columns are only allocated when something needs them, and
+// workers fill in their own slice of them directly. puzzles the run's budget
+// didn't reach are left untested
+int results_columns(struct result* results, size_t modules, size_t puzzles)
+{
+	int i;
+
+	for (i = 0; i < modules; ++i) {
+		results[i].durations = calloc(puzzles, sizeof(uint64_t));
+		results[i].outcomes = calloc(puzzles, sizeof(uint8_t));
+		if (!results[i].durations || !results[i].outcomes) {
+			fputs("failed to allocate puzzle columns\n", stderr);
+			return -ENOMEM;
+		}
+
+		memset(results[i].outcomes, OUTCOME_UNTESTED, puzzles);
+	}
+
+	return 0;
+}
+
+// with a single worker the puzzles are tested on the calling thread.
+// additional workers are pinned round robin to the cpus we are allowed to run
+// on
+//
+// batch modules are handed chunks of the slice, and when any are loaded the
+// other modules walk the same chunks puzzle by puzzle so that every module
+// still sees the corpus in the same order
+int workers_run(struct worker* workers, const struct config* config,
+	const struct corpus* corpus, const struct result* results,
+	size_t modules)
+{
+	int status, failed = 0, cpu = -1, t, started, i;
+	size_t threads = config->threads, chunk = 1;
+	uint64_t deadline = 0;
+	cpu_set_t allowed, set;
+	pthread_attr_t attr;
+	struct watchdog watchdog;
+	_Atomic size_t* strikes = NULL;
+	_Atomic bool stop = false;
+
+	for (i = 0; i < modules && config->batch > 0; ++i)
+		if (module_batched(&results[i].module))
+			chunk = config->batch;
+
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) < 0)
+		CPU_ZERO(&allowed);
+
+	// every worker's wrong answers count towards the same limit
+	if (config->max_incorrect > 0) {
+		strikes = calloc(modules, sizeof(*strikes));
+		if (!strikes) {
+			fputs("failed to allocate workers\n", stderr);
+			return -ENOMEM;
+		}
+	}
+
+	if (config->timeout > 0) {
+		status = watchdog_start(&watchdog, config->timeout, threads);
+		if (status < 0) {
+			free(strikes);
+			return status;
+		}
+	}
+
+	if (config->budget > 0)
+		deadline = monotonic_ns() + config->budget;
+
+	for (t = 0; t < threads; ++t) {
+		struct worker* worker = &workers[t];
+
+		memset(worker, 0, sizeof(*worker));
+		worker->corpus = corpus;
+		worker->begin = (corpus->len * t) / threads;
+		worker->end = (corpus->len * (t + 1)) / threads;
+		worker->results = results;
+		worker->modules = modules;
+		worker->config = config;
+		worker->chunk = chunk;
+		worker->deadline = deadline;
+		worker->strikes = strikes;
+		worker->stop = &stop;
+		if (config->timeout > 0)
+			worker->watch = &watchdog.watches[t];
+
+		rng_seed(&worker->rng, config->seed, t);
+		worker->cpu = -1;
+
+		if (threads > 1 && CPU_COUNT(&allowed) > 0) {
+			do {
+				cpu = (cpu + 1) % CPU_SETSIZE;
+			} while (!CPU_ISSET(cpu, &allowed));
+
+			worker->cpu = cpu;
+		}
+	}
+
+	if (threads == 1) {
+		worker_run(&workers[0]);
+		status = workers[0].status;
+		goto out;
+	}
+
+	for (t = 0; t < threads; ++t) {
+		pthread_attr_init(&attr);
+		if (workers[t].cpu >= 0) {
+			CPU_ZERO(&set);
+			CPU_SET(workers[t].cpu, &set);
+			pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+		}
+
+		status = pthread_create(&workers[t].thread, &attr, worker_run,
+			&workers[t]);
+		pthread_attr_destroy(&attr);
+		if (status != 0) {
+			fputs("failed to start worker\n", stderr);
+			failed = -status;
+			break;
+		}
+	}
+
+	// the workers already started are stopped at their next puzzle and
+	// joined before the error is returned, so that none outlives the run
+	started = t;
+	if (failed < 0)
+		atomic_store(&stop, true);
+
+	status = failed;
+	for (t = 0; t < started; ++t) {
+		pthread_join(workers[t].thread, NULL);
+		if (workers[t].status < 0 && failed == 0)
+			status = workers[t].status;
+	}
+
+out:
+	if (config->timeout > 0)
+		watchdog_stop(&watchdog);
+
+	free(strikes);
+
+	return status;
+}
+
+// samples are only sorted here, once every worker has finished, each
+// worker's arena chunk by chunk and then all of them merged together
+int workers_merge(struct worker* workers, size_t threads,
+	struct result* results, size_t modules)
+{
+	int status = 0, t, i, k;
+	struct arena** arenas = malloc(sizeof(*arenas) * threads);
+
+	if (!arenas)
+		status = -ENOMEM;
+
+	for (i = 0; i < modules; ++i) {
+		struct samples* samples = &results[i].samples;
+
+		for (t = 0; arenas && t < threads; ++t)
+			arenas[t] = &workers[t].arenas[i];
+
+		if (status == 0)
+			status = arena_merge(arenas, threads, samples);
+
+		for (t = 0; t < threads; ++t) {
+			struct worker* worker = &workers[t];
+
+			arena_free(&worker->arenas[i]);
+			results[i].elapsed += worker->elapsed[i];
+			results[i].tally.tested += worker->tallies[i].tested;
+			results[i].tally.incorrect +=
+				worker->tallies[i].incorrect;
+			results[i].tally.timeouts +=
+				worker->tallies[i].timeouts;
+			results[i].tally.divergent +=
+				worker->tallies[i].divergent;
+
+			if (worker->counted[i] == 0)
+				continue;
+
+			results[i].available = perf_available(&worker->perf);
+			for (k = 0; k < PERF_COUNTERS; ++k)
+				results[i].counters[k] +=
+					worker->counters[i * PERF_COUNTERS + k];
+
+			results[i].counted += worker->counted[i];
+		}
+
+		for (t = 0; t < threads; ++t) {
+			effort_merge(&results[i].effort,
+				&workers[t].efforts[i]);
+			if (results[i].cold)
+				histogram_merge(results[i].cold,
+					&workers[t].colds[i]);
+		}
+	}
+
+	free(arenas);
+
+	for (t = 0; t < threads; ++t) {
+		free(workers[t].arenas);
+		free(workers[t].tallies);
+		free(workers[t].elapsed);
+		free(workers[t].scratch);
+		free(workers[t].solutions);
+		free(workers[t].incorrect);
+		free(workers[t].repeats);
+		free(workers[t].order);
+		free(workers[t].counters);
+		free(workers[t].counted);
+		free(workers[t].sources);
+		free(workers[t].efforts);
+		free(workers[t].colds);
+		eviction_free(&workers[t].eviction);
+		if (workers[t].config->perf)
+			perf_close(&workers[t].perf);
+	}
+
+	return status;
+}
+
+// the sample buffers are allocated by the worker itself so that they are
+// first touched, and therefore placed, on the node it is pinned to. each
+// module's samples go into an arena of their own that grows as they come in
+void* worker_run(void* arg)
+{
+	int i;
+	size_t n, k, count;
+	struct worker* worker = arg;
+	const struct config* config = worker->config;
+
+	worker->arenas = calloc(worker->modules, sizeof(struct arena));
+	worker->tallies = calloc(worker->modules, sizeof(struct tally));
+	worker->elapsed = calloc(worker->modules, sizeof(uint64_t));
+	worker->scratch = aligned_alloc(CACHE_LINE_SIZE,
+		ALIGN_UP(sizeof(int) * SUDOKU_SIZE * worker->chunk,
+			CACHE_LINE_SIZE));
+	worker->solutions = aligned_alloc(CACHE_LINE_SIZE,
+		ALIGN_UP(SUDOKU_SIZE * worker->chunk, CACHE_LINE_SIZE));
+	worker->incorrect = calloc(worker->chunk, sizeof(bool));
+	worker->repeats = calloc(config->repeat, sizeof(uint64_t));
+	worker->order = calloc(worker->modules, sizeof(size_t));
+	worker->counters = calloc(worker->modules, sizeof(uint64_t)
+		* PERF_COUNTERS);
+	worker->counted = calloc(worker->modules, sizeof(uint64_t));
+	worker->sources = calloc(worker->modules,
+		sizeof(struct solver_stats*));
+	worker->efforts = calloc(worker->modules, sizeof(struct effort));
+	if (!worker->arenas || !worker->tallies || !worker->elapsed
+		|| !worker->scratch
+		|| !worker->solutions || !worker->incorrect
+		|| !worker->repeats || !worker->order
+		|| !worker->counters || !worker->counted || !worker->sources
+		|| !worker->efforts) {
+		fputs("failed to allocate worker samples\n", stderr);
+		worker->status = -ENOMEM;
+		return NULL;
+	}
+
+	if (config->cold) {
+		worker->colds = malloc(sizeof(struct histogram)
+			* worker->modules);
+		if (!worker->colds) {
+			fputs("failed to allocate worker samples\n", stderr);
+			worker->status = -ENOMEM;
+			return NULL;
+		}
+
+		for (i = 0; i < worker->modules; ++i)
+			histogram_reset(&worker->colds[i]);
+
+		worker->status = eviction_init(&worker->eviction,
+			config->cold);
+		if (worker->status < 0)
+			return NULL;
+	}
+
+	// the counters follow the thread that opens them
+	if (config->perf) {
+		worker->status = perf_open(&worker->perf);
+		if (worker->status < 0)
+			return NULL;
+	}
+
+	if (worker->watch)
+		watch_enter(worker->watch);
+
+	for (i = 0; i < worker->modules; ++i) {
+		arena_init(&worker->arenas[i]);
+		worker->order[i] = i;
+		if (config->effort)
+			worker->sources[i] =
+				module_stats(&worker->results[i].module);
+	}
+
+	if (config->schedule == SCHEDULE_BLOCKED) {
+		for (i = 0; i < worker->modules; ++i) {
+			for (n = worker->begin; n < worker->end; n += count) {
+				count = worker->end - n < worker->chunk
+					? worker->end - n : worker->chunk;
+
+				if (worker_expired(worker))
+					return NULL;
+
+				if (worker_chunk(worker, i, n, count) < 0)
+					return NULL;
+			}
+		}
+
+		return NULL;
+	}
+
+	for (n = worker->begin; n < worker->end; n += count) {
+		count = worker->end - n < worker->chunk
+			? worker->end - n : worker->chunk;
+
+		if (worker_expired(worker))
+			return NULL;
+
+		// a fisher-yates shuffle of the module order for every chunk
+		if (config->schedule == SCHEDULE_SHUFFLE) {
+			for (k = worker->modules - 1; k > 0; --k) {
+				size_t j = rng_below(&worker->rng, k + 1);
+				size_t tmp = worker->order[k];
+
+				worker->order[k] = worker->order[j];
+				worker->order[j] = tmp;
+			}
+		}
+
+		for (i = 0; i < worker->modules; ++i)
+			if (worker_chunk(worker, worker->order[i], n,
+				count) < 0)
+				return NULL;
+	}
+
+	return NULL;
+}
+
+// tests module i against count puzzles starting from puzzle n
+int worker_chunk(struct worker* worker, int i, size_t n, size_t count)
+{
+	int status;
+	size_t k;
+	enum outcome outcome, batch;
+	uint64_t duration;
+	const struct config* config = worker->config;
+	const struct module* module = &worker->results[i].module;
+	const uint8_t* puzzle = corpus_get(worker->corpus, n);
+
+	if (worker_struck(worker, i))
+		return 0;
+
+	worker->source = worker->sources[i];
+	if (!module_batched(module) || config->batch == 0) {
+		for (k = 0; k < count && !worker_struck(worker, i); ++k) {
+			if (config->cold)
+				worker_cold(worker, i, n + k);
+
+			outcome = worker_test(worker, module, n + k, &duration);
+			worker->elapsed[i] += duration;
+			worker_count(worker, i);
+			if (worker_inspect(worker, module, n + k, outcome,
+				worker->output))
+				++worker->tallies[i].divergent;
+
+			status = worker_record(worker, i, n + k, outcome,
+				duration);
+			if (status < 0)
+				return status;
+		}
+
+		return 0;
+	}
+
+	// a batch's cold solves are all one puzzle at a time
+	for (k = 0; config->cold && k < count; ++k)
+		worker_cold(worker, i, n + k);
+
+	// every puzzle in the batch is credited with an equal share of the
+	// batch's time, and a batch that runs out of time times out as a whole
+	batch = worker_test_batch(worker, module, n, count, &duration);
+	worker->elapsed[i] += duration;
+	worker_count(worker, i);
+
+	for (k = 0; k < count; ++k) {
+		outcome = batch;
+		if (outcome == OUTCOME_SOLVED && worker->incorrect[k])
+			outcome = OUTCOME_INCORRECT;
+
+		if (worker_inspect(worker, module, n + k, outcome,
+			&worker->solutions[k * SUDOKU_SIZE]))
+			++worker->tallies[i].divergent;
+
+		status = worker_record(worker, i, n + k, outcome,
+			duration / count);
+		if (status < 0)
+			return status;
+	}
+
+	return 0;
+}
+
+// credits module i with the counts from the solves since the last call
+void worker_count(struct worker* worker, int i)
+{
+	if (worker->config->perf)
+		perf_drain(&worker->perf, &worker->counters[i * PERF_COUNTERS],
+			&worker->counted[i]);
+
+	if (worker->efforts)
+		effort_merge(&worker->efforts[i], &worker->effort);
+
+	memset(&worker->effort, 0, sizeof(worker->effort));
+}
+
+void effort_merge(struct effort* dst, const struct effort* src)
+{
+	dst->stats.nodes += src->stats.nodes;
+	dst->stats.guesses += src->stats.guesses;
+	dst->stats.backtracks += src->stats.backtracks;
+	dst->stats.propagations += src->stats.propagations;
+	dst->solves += src->solves;
+}
+
+// with --max-incorrect, whether module i has given so many wrong answers that
+// it's left out of the rest of the run
+bool worker_struck(const struct worker* worker, int i)
+{
+	size_t limit = worker->config->max_incorrect;
+
+	return worker->strikes && atomic_load_explicit(&worker->strikes[i],
+		memory_order_relaxed) >= limit;
+}
+
+// a solution that's legal but isn't the one the reference found first, on a
+// puzzle with several, could still be a module that's wrong by luck. such
+// solutions are counted as divergent, and along with wrong answers and failed
+// solves are written to the failure log with whatever the module left in the
+// grid
+bool worker_inspect(struct worker* worker, const struct module* module,
+	size_t n, enum outcome outcome, const uint8_t* grid)
+{
+	int k;
+	char cells[SUDOKU_SIZE + 1];
+	const struct config* config = worker->config;
+	bool divergent = outcome == OUTCOME_SOLVED && diverges(config, n, grid);
+	const char* kind = divergent ? "divergent"
+		: outcome == OUTCOME_INCORRECT ? "incorrect"
+		: outcome == OUTCOME_FAILED ? "failed" : NULL;
+
+	if (!config->failures || !kind)
+		return divergent;
+
+	for (k = 0; k < SUDOKU_SIZE; ++k)
+		cells[k] = grid[k] <= 9 ? '0' + grid[k] : '?';
+
+	cells[SUDOKU_SIZE] = '\0';
+	fprintf(config->failures, "%s,%zu,%s,%s\n", module->name, n, kind,
+		cells);
+	return divergent;
+}
+
+// a single solve of puzzle n straight after the caches have been thrashed,
+// from a grid somewhere in the eviction buffer. it's counted towards the cold
+// latency if it was solved, and otherwise left for the timed solves to record
+void worker_cold(struct worker* worker, int i, size_t n)
+{
+	uint64_t duration;
+	int* scratch;
+	uint8_t* solution;
+	enum outcome outcome;
+	const struct config* config = worker->config;
+
+	eviction_run(&worker->eviction);
+	scratch = eviction_place(&worker->eviction, &worker->rng,
+		(sizeof(int) + 1) * SUDOKU_SIZE);
+	solution = (uint8_t*)&scratch[SUDOKU_SIZE];
+
+	outcome = test_in(&worker->results[i].module,
+		corpus_get(worker->corpus, n), expected(config, n),
+		&config->clock, NULL, worker->watch, scratch, solution,
+		&duration);
+	if (outcome == OUTCOME_SOLVED)
+		histogram_add(&worker->colds[i], duration);
+}
+
+// the module's counts are read before the timed solves and after them, so
+// that warmups don't count
+static void worker_effort(struct worker* worker,
+	const struct solver_stats* before, size_t solves)
+{
+	const struct solver_stats* after = worker->source;
+
+	if (!after)
+		return;
+
+	worker->effort.stats.nodes += after->nodes - before->nodes;
+	worker->effort.stats.guesses += after->guesses - before->guesses;
+	worker->effort.stats.backtracks += after->backtracks
+		- before->backtracks;
+	worker->effort.stats.propagations += after->propagations
+		- before->propagations;
+	worker->effort.solves += solves;
+}
+
+// whether the run's budget has been spent or the run is being abandoned, in
+// which case the worker tests nothing more
+bool worker_expired(const struct worker* worker)
+{
+	if (worker->stop && atomic_load(worker->stop))
+		return true;
+
+	return worker->deadline > 0 && monotonic_ns() >= worker->deadline;
+}
+
+// puzzle n and its expected solution are fetched into the cache ahead of
+// their turn, while the puzzles before them are solving
+static void worker_prefetch(const struct worker* worker, size_t n)
+{
+	const uint8_t* puzzle;
+	const uint8_t* solution;
+
+	if (n >= worker->corpus->len)
+		return;
+
+	puzzle = corpus_get(worker->corpus, n);
+	__builtin_prefetch(puzzle);
+	__builtin_prefetch(puzzle + SUDOKU_SIZE - 1);
+
+	solution = expected(worker->config, n);
+	if (solution) {
+		__builtin_prefetch(solution);
+		__builtin_prefetch(solution + SUDOKU_SIZE - 1);
+	}
+}
+
+// runs the warmup solves untimed, then reduces the timed repeats to a single
+// duration. the puzzle is staged in the worker's own buffers, and a puzzle
+// only counts as solved if every repeat solved it, each repeat's solution
+// being verified once its clock has been read
+enum outcome worker_test(struct worker* worker, const struct module* module,
+	size_t n, uint64_t* duration)
+{
+	int r;
+	enum outcome outcome;
+	const struct config* config = worker->config;
+	const uint8_t* puzzle = corpus_get(worker->corpus, n);
+	struct perf* perf = config->perf ? &worker->perf : NULL;
+	struct solver_stats before;
+
+	worker_prefetch(worker, n + PREFETCH_DISTANCE);
+
+	for (r = 0; r < config->warmup; ++r)
+		solve_in(module, puzzle, &config->clock, NULL, worker->watch,
+			worker->wide, worker->output, duration);
+
+	if (worker->source)
+		before = *worker->source;
+
+	for (r = 0; r < config->repeat; ++r) {
+		outcome = test_in(module, puzzle, expected(config, n),
+			&config->clock, perf, worker->watch, worker->wide,
+			worker->output, duration);
+		if (outcome != OUTCOME_SOLVED) {
+			worker_effort(worker, &before, r + 1);
+			return outcome;
+		}
+
+		worker->repeats[r] = *duration;
+	}
+
+	worker_effort(worker, &before, config->repeat);
+
+	*duration = reduce_repeats(worker->repeats, config->repeat,
+		config->reduce);
+	return OUTCOME_SOLVED;
+}
+
+// the same for a whole batch of puzzles n on. a puzzle that any repeat got
+// wrong is flagged in incorrect rather than failing the batch, so that the
+// others are still credited
+enum outcome worker_test_batch(struct worker* worker,
+	const struct module* module, size_t n, size_t count,
+	uint64_t* duration)
+{
+	int r;
+	size_t k;
+	const uint8_t* puzzles = corpus_get(worker->corpus, n);
+	enum outcome outcome;
+	const struct config* config = worker->config;
+	struct perf* perf = config->perf ? &worker->perf : NULL;
+	struct solver_stats before;
+
+	memset(worker->incorrect, 0, count * sizeof(bool));
+	for (r = 0; r < config->warmup; ++r)
+		test_batch(module, puzzles, count, worker->scratch,
+			worker->solutions, &config->clock, NULL,
+			worker->watch, duration);
+
+	if (worker->source)
+		before = *worker->source;
+
+	for (r = 0; r < config->repeat; ++r) {
+		outcome = test_batch(module, puzzles, count, worker->scratch,
+			worker->solutions, &config->clock, perf,
+			worker->watch, duration);
+		if (outcome != OUTCOME_SOLVED) {
+			worker_effort(worker, &before, count * (r + 1));
+			return outcome;
+		}
+
+		worker->repeats[r] = *duration;
+		for (k = 0; k < count; ++k)
+			worker->incorrect[k] |= verify(
+				&puzzles[k * SUDOKU_SIZE],
+				expected(config, n + k),
+				&worker->solutions[k * SUDOKU_SIZE]) < 0;
+	}
+
+	worker_effort(worker, &before, count * config->repeat);
+
+	*duration = reduce_repeats(worker->repeats, config->repeat,
+		config->reduce);
+	return OUTCOME_SOLVED;
+}
+
+uint64_t reduce_repeats(uint64_t* repeats, size_t n, enum reduce reduce)
+{
+	size_t i, j;
+	uint64_t val, min = repeats[0];
+
+	if (reduce == REDUCE_MIN) {
+		for (i = 1; i < n; ++i)
+			if (repeats[i] < min)
+				min = repeats[i];
+
+		return min;
+	}
+
+	// there are only ever a handful of repeats
+	for (i = 1; i < n; ++i) {
+		val = repeats[i];
+		for (j = i; j > 0 && repeats[j - 1] > val; --j)
+			repeats[j] = repeats[j - 1];
+
+		repeats[j] = val;
+	}
+
+	return repeats[n / 2];
+}
+
+// every outcome is kept for the export, but only solved puzzles are sampled
+int worker_record(struct worker* worker, int i, size_t n, enum outcome outcome,
+	uint64_t duration)
+{
+	int status;
+	const struct result* result = &worker->results[i];
+	struct tally* tally = &worker->tallies[i];
+
+	if (result->outcomes) {
+		result->durations[n] = duration;
+		result->outcomes[n] = outcome;
+	}
+
+	++tally->tested;
+	if (outcome == OUTCOME_INCORRECT && worker->strikes)
+		atomic_fetch_add_explicit(&worker->strikes[i], 1,
+			memory_order_relaxed);
+
+	if (outcome == OUTCOME_INCORRECT)
+		++tally->incorrect;
+	else if (outcome == OUTCOME_TIMEOUT)
+		++tally->timeouts;
+
+	if (outcome != OUTCOME_SOLVED)
+		return 0;
+
+	status = arena_append(&worker->arenas[i], duration);
+	if (status < 0) {
+		fputs("failed to insert stat\n", stderr);
+		worker->status = status;
+		return status;
+	}
+
+	return 0;
+}
+
+// the reference's solution to puzzle n, if it's known to be the only one
+const uint8_t* expected(const struct config* config, size_t n)
+{
+	const uint8_t* solution;
+
+	if (!config->solutions)
+		return NULL;
+
+	solution = &config->solutions[n * SUDOKU_SIZE];
+	if (solution[0] == 0 || (config->ambiguous && config->ambiguous[n]))
+		return NULL;
+
+	return solution;
+}
+
+// whether a solution differs from the reference's first solution to a puzzle
+// that has several
+bool diverges(const struct config* config, size_t n, const uint8_t* solution)
+{
+	if (!config->ambiguous || !config->ambiguous[n])
+		return false;
+
+	return memcmp(solution, &config->solutions[n * SUDOKU_SIZE],
+		SUDOKU_SIZE) != 0;
+}
+
+// the log is line buffered so that records from isolated children, which
+// share the file, are each written whole
+int failures_open(struct config* config, const char* filename)
+{
+	config->failures = fopen(filename, "w");
+	if (!config->failures) {
+		fprintf(stderr, "failed to open %s\n", filename);
+		return -errno;
+	}
+
+	setvbuf(config->failures, NULL, _IOLBF, 0);
+	fputs("name,puzzle,outcome,grid\n", config->failures);
+	return 0;
+}
+
+// a puzzle with a known unique solution only needs a compare, anything else
+// has to be checked against the rules
+int verify(const uint8_t* puzzle, const uint8_t* expected,
+	const uint8_t* solution)
+{
+	if (expected)
+		return memcmp(solution, expected, SUDOKU_SIZE) == 0 ? 0 : -1;
+
+	return cross_check(puzzle, solution);
+}
+
+// modules on the int ABI are timed against a widened copy of the puzzle, and
+// their solution is narrowed back afterwards, both off the clock. when perf is
+// given its counters are read just outside the clock reads
+//
+// under a watch the module is armed just outside the clock reads too, and a
+// solve that's interrupted lands back at the sigsetjmp with the time it took
+// to be cut off. start is volatile as it's the one local read after the jump
+enum outcome test(const struct module* module, const uint8_t* puzzle,
+	const uint8_t* expected, const struct clock_source* clock,
+	struct perf* perf, struct watch* watch, uint64_t* duration)
+{
+	int scratch[SUDOKU_SIZE];
+	uint8_t solution[SUDOKU_SIZE];
+
+	return test_in(module, puzzle, expected, clock, perf, watch, scratch,
+		solution, duration);
+}
+
+// the same, with the module solving in the buffers given rather than on the
+// stack
+enum outcome test_in(const struct module* module, const uint8_t* puzzle,
+	const uint8_t* expected, const struct clock_source* clock,
+	struct perf* perf, struct watch* watch, int* scratch,
+	uint8_t* solution, uint64_t* duration)
+{
+	enum outcome outcome;
+
+	outcome = solve_in(module, puzzle, clock, perf, watch, scratch,
+		solution, duration);
+	if (outcome != OUTCOME_SOLVED)
+		return outcome;
+
+	if (verify(puzzle, expected, solution) < 0)
+		return OUTCOME_INCORRECT;
+
+	return OUTCOME_SOLVED;
+}
+
+// only times the solve, leaving the solution unchecked
+enum outcome solve_in(const struct module* module, const uint8_t* puzzle,
+	const struct clock_source* clock, struct perf* perf,
+	struct watch* watch, int* scratch, uint8_t* solution,
+	uint64_t* duration)
+{
+	int status;
+	volatile uint64_t start = 0;
+	uint64_t finish;
+
+	if (watch && sigsetjmp(watch->env, 0)) {
+		finish = clock_read(clock);
+		watch_disarm(watch);
+		*duration = clock_elapsed(clock, start, finish);
+		return OUTCOME_TIMEOUT;
+	}
+
+	if (module->solve_u8) {
+		memcpy(solution, puzzle, SUDOKU_SIZE);
+
+		if (perf)
+			perf_begin(perf);
+		if (watch)
+			watch_arm(watch, 1);
+		start = clock_read(clock);
+		status = module->solve_u8(solution);
+		finish = clock_read(clock);
+		if (watch)
+			watch_disarm(watch);
+		if (perf)
+			perf_end(perf, 1);
+	} else {
+		grid_widen(scratch, puzzle, 1);
+
+		if (perf)
+			perf_begin(perf);
+		if (watch)
+			watch_arm(watch, 1);
+		start = clock_read(clock);
+		status = module->solve(scratch);
+		finish = clock_read(clock);
+		if (watch)
+			watch_disarm(watch);
+		if (perf)
+			perf_end(perf, 1);
+
+		grid_narrow(solution, scratch, 1);
+	}
+
+	*duration = clock_elapsed(clock, start, finish);
+
+	return status < 0 ? OUTCOME_FAILED : OUTCOME_SOLVED;
+}
+
+// scratch and solutions must have room for n puzzles. only the call itself is
+// timed, and a batch the module reports as solved still has each of its
+// solutions checked by the caller
+enum outcome test_batch(const struct module* module, const uint8_t* puzzles,
+	size_t n, int* scratch, uint8_t* solutions,
+	const struct clock_source* clock, struct perf* perf,
+	struct watch* watch, uint64_t* duration)
+{
+	int status;
+	volatile uint64_t start = 0;
+	uint64_t finish;
+
+	if (watch && sigsetjmp(watch->env, 0)) {
+		finish = clock_read(clock);
+		watch_disarm(watch);
+		*duration = clock_elapsed(clock, start, finish);
+		return OUTCOME_TIMEOUT;
+	}
+
+	if (module->solve_batch_u8) {
+		memcpy(solutions, puzzles, SUDOKU_SIZE * n);
+
+		if (perf)
+			perf_begin(perf);
+		if (watch)
+			watch_arm(watch, n);
+		start = clock_read(clock);
+		status = module->solve_batch_u8(solutions, n);
+		finish = clock_read(clock);
+		if (watch)
+			watch_disarm(watch);
+		if (perf)
+			perf_end(perf, n);
+	} else {
+		grid_widen(scratch, puzzles, n);
+
+		if (perf)
+			perf_begin(perf);
+		if (watch)
+			watch_arm(watch, n);
+		start = clock_read(clock);
+		status = module->solve_batch(scratch, n);
+		finish = clock_read(clock);
+		if (watch)
+			watch_disarm(watch);
+		if (perf)
+			perf_end(perf, n);
+
+		grid_narrow(solutions, scratch, n);
+	}
+
+	*duration = clock_elapsed(clock, start, finish);
+
+	return status < 0 ? OUTCOME_FAILED : OUTCOME_SOLVED;
+}
+
+void grid_widen(int* dst, const uint8_t* src, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < SUDOKU_SIZE * n; ++i)
+		dst[i] = src[i];
+}
+
+// anything a module writes that isn't a digit is narrowed to a value that
+// cross_check() rejects
+void grid_narrow(uint8_t* dst, const int* src, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < SUDOKU_SIZE * n; ++i)
+		dst[i] = (unsigned)src[i] <= 9 ? src[i] : UINT8_MAX;
+}
@@ -0,0 +1,206 @@
+// Sudoku Master Runner
+//
+// Author: Matthew Knight
+// File Name: runner.h
+// Date: 2026-10-14
+//
+// The runner tests every loaded module against the corpus and collects the
+// samples, either in process on one or more worker threads, or out of process
+// (see isolate.h).
+
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "arena.h"
+#include "corpus.h"
+#include "module.h"
+#include "perf.h"
+#include "pressure.h"
+#include "random.h"
+#include "stats.h"
+#include "sudoku.h"
+#include "timing.h"
+#include "watchdog.h"
+
+#define DEFAULT_BATCH_SIZE 16
+
+// how many puzzles ahead of the one solving a worker fetches into the cache
+#define PREFETCH_DISTANCE 4
+
+enum reduce {
+    REDUCE_MIN,
+    REDUCE_MEDIAN,
+};
+
+// the fate of one puzzle against one module
+enum outcome {
+    OUTCOME_SOLVED,
+    OUTCOME_FAILED,
+    OUTCOME_LOST,
+    OUTCOME_INCORRECT,
+    OUTCOME_TIMEOUT,
+    OUTCOME_UNTESTED,
+};
+
+enum schedule {
+    SCHEDULE_IN_ORDER,
+    SCHEDULE_SHUFFLE,
+    SCHEDULE_BLOCKED,
+};
+
+struct config {
+    struct clock_source clock;
+    size_t threads;
+    size_t batch;
+    size_t warmup;
+    size_t repeat;
+    enum reduce reduce;
+    enum schedule schedule;
+    uint64_t seed;
+    bool isolate;
+    uint64_t timeout;
+    uint64_t budget;
+    size_t cold;
+    bool perf;
+    bool effort;
+    const char* export;
+    bool reference;
+    bool dedup;
+    bool difficulty;
+    bool compare;
+    size_t max_incorrect;
+    FILE* failures;
+    const uint8_t* solutions;
+    const uint8_t* ambiguous;
+    const uint8_t* buckets;
+    bool stream;
+    size_t every;
+    size_t interval;
+};
+
+// what became of the puzzles that were tested against one module, beyond the
+// solved ones that were sampled
+struct tally {
+    size_t tested;
+    size_t incorrect;
+    size_t timeouts;
+    size_t divergent;
+};
+
+// the search effort a module reported over its timed solves, with solves
+// counting each puzzle of a batch
+struct effort {
+    struct solver_stats stats;
+    uint64_t solves;
+};
+
+struct result {
+    struct module module;
+    struct tally tally;
+    uint64_t elapsed;
+    struct samples samples;
+    unsigned available;
+    uint64_t counters[PERF_COUNTERS];
+    uint64_t counted;
+    struct effort effort;
+    uint64_t* durations;
+    uint8_t* outcomes;
+    struct histogram* histogram;
+    struct histogram* cold;
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+// each worker tests every module against its own contiguous slice of the
+// corpus, and keeps its samples to itself until the merge at the end of the run
+struct worker {
+    pthread_t thread;
+    int cpu;
+    const struct config* config;
+    const struct corpus* corpus;
+    size_t begin;
+    size_t end;
+    size_t chunk;
+    uint64_t deadline;
+    const struct result* results;
+    size_t modules;
+    struct arena* arenas;
+    struct tally* tallies;
+    uint64_t* elapsed;
+    int* scratch;
+    uint8_t* solutions;
+    bool* incorrect;
+    uint64_t* repeats;
+    size_t* order;
+    struct rng rng;
+    struct perf perf;
+    uint64_t* counters;
+    uint64_t* counted;
+    struct solver_stats** sources;
+    struct solver_stats* source;
+    struct effort effort;
+    struct effort* efforts;
+    struct eviction eviction;
+    struct histogram* colds;
+    _Atomic size_t* strikes;
+    _Atomic bool* stop;
+    int wide[SUDOKU_SIZE] __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint8_t output[SUDOKU_SIZE] __attribute__((aligned(CACHE_LINE_SIZE)));
+    struct watch* watch;
+    int status;
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+int results_columns(struct result* results, size_t modules, size_t puzzles);
+int workers_run(struct worker* workers, const struct config* config,
+	const struct corpus* corpus, const struct result* results,
+	size_t modules);
+int workers_merge(struct worker* workers, size_t threads,
+	struct result* results, size_t modules);
+void* worker_run(void* arg);
+int worker_chunk(struct worker* worker, int i, size_t n, size_t count);
+void worker_count(struct worker* worker, int i);
+void effort_merge(struct effort* dst, const struct effort* src);
+void worker_cold(struct worker* worker, int i, size_t n);
+bool worker_struck(const struct worker* worker, int i);
+bool worker_inspect(struct worker* worker, const struct module* module,
+	size_t n, enum outcome outcome, const uint8_t* grid);
+bool worker_expired(const struct worker* worker);
+enum outcome worker_test(struct worker* worker, const struct module* module,
+	size_t n, uint64_t* duration);
+enum outcome worker_test_batch(struct worker* worker,
+	const struct module* module, size_t n, size_t count,
+	uint64_t* duration);
+int worker_record(struct worker* worker, int i, size_t n, enum outcome outcome,
+	uint64_t duration);
+uint64_t reduce_repeats(uint64_t* repeats, size_t n, enum reduce reduce);
+
+const uint8_t* expected(const struct config* config, size_t n);
+bool diverges(const struct config* config, size_t n, const uint8_t* solution);
+int failures_open(struct config* config, const char* filename);
+int verify(const uint8_t* puzzle, const uint8_t* expected,
+	const uint8_t* solution);
+enum outcome test(const struct module* module, const uint8_t* puzzle,
+	const uint8_t* expected, const struct clock_source* clock,
+	struct perf* perf, struct watch* watch, uint64_t* duration);
+enum outcome test_in(const struct module* module, const uint8_t* puzzle,
+	const uint8_t* expected, const struct clock_source* clock,
+	struct perf* perf, struct watch* watch, int* scratch,
+	uint8_t* solution, uint64_t* duration);
+enum outcome solve_in(const struct module* module, const uint8_t* puzzle,
+	const struct clock_source* clock, struct perf* perf,
+	struct watch* watch, int* scratch, uint8_t* solution,
+	uint64_t* duration);
+enum outcome test_batch(const struct module* module, const uint8_t* puzzles,
+	size_t n, int* scratch, uint8_t* solutions,
+	const struct clock_source* clock, struct perf* perf,
+	struct watch* watch, uint64_t* duration);
+
+void grid_widen(int* dst, const uint8_t* src, size_t n);
+void grid_narrow(uint8_t* dst, const int* src, size_t n);
+
+#endif
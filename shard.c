@@ -0,0 +1,832 @@
+// Sudoku Master Sharding
+//
+// Author: Matthew Knight
+// File Name: shard.c
+// Date: 2026-10-14
+//
+// The coordinator serves every worker from a thread of its own, which hands
+// out a shard, blocks until its report comes back, and merges it under the
+// lock. Messages are fixed size structs in the host's byte order, so every
+// machine taking part must share an architecture, which the hello's magic
+// number checks. A worker is only given shards once its corpus and modules
+// have been checked against the coordinator's.
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "module.h"
+#include "shard.h"
+
+#define SHARD_MAGIC 0x31445241485353ull // "SSHARD1" read as an integer
+#define SHARD_STRING_SIZE 80
+#define SHARD_POLL_MS 100
+
+// a worker whose machine goes quiet is given up on after about half a minute
+#define SHARD_KEEPALIVE_IDLE_S 10
+#define SHARD_KEEPALIVE_INTERVAL_S 5
+#define SHARD_KEEPALIVE_COUNT 3
+
+// on top of the longest a shard can take under --timeout, for the transfer
+#define SHARD_REPORT_SLACK_MS 60000
+
+struct shard_hello {
+    uint64_t magic;
+    uint64_t puzzles;
+    uint64_t hash;
+    uint64_t modules;
+};
+
+struct shard_identity {
+    char name[SHARD_STRING_SIZE];
+    char author[SHARD_STRING_SIZE];
+};
+
+// the coordinator's settings for how every puzzle is tested, which override
+// the worker's own
+struct shard_plan {
+    uint64_t batch;
+    uint64_t warmup;
+    uint64_t repeat;
+    uint64_t reduce;
+    uint64_t schedule;
+    uint64_t seed;
+    uint64_t timeout;
+    uint64_t perf;
+    uint64_t effort;
+};
+
+// an empty range tells the worker there's nothing left
+struct shard_range {
+    uint64_t begin;
+    uint64_t end;
+};
+
+// one for every module, in the order the modules were given
+struct shard_report {
+    uint64_t tested;
+    uint64_t incorrect;
+    uint64_t timeouts;
+    uint64_t elapsed;
+    uint64_t available;
+    uint64_t counted;
+    uint64_t counters[PERF_COUNTERS];
+    struct effort effort;
+    struct histogram histogram;
+};
+
+// changed is signalled whenever a shard is requeued or merged, or the run
+// stops, which is what idle workers wait on
+struct coordinator {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    const struct config* config;
+    const struct corpus* corpus;
+    uint64_t hash;
+    size_t shard_size;
+    size_t next;
+    _Atomic size_t completed;
+    struct shard_range* retries;
+    size_t retries_len;
+    struct result* results;
+    size_t modules;
+    bool stopped;
+};
+
+struct connection {
+    pthread_t thread;
+    struct coordinator* coordinator;
+    int fd;
+    char peer[NI_MAXHOST + NI_MAXSERV + 2];
+};
+
+static int shard_send(int fd, const void* buf, size_t len)
+{
+	ssize_t status;
+	const char* data = buf;
+
+	while (len > 0) {
+		status = send(fd, data, len, MSG_NOSIGNAL);
+		if (status < 0 && errno == EINTR)
+			continue;
+		if (status < 0)
+			return -errno;
+
+		data += status;
+		len -= status;
+	}
+
+	return 0;
+}
+
+// a connection closed partway through a message is an error like any other
+static int shard_recv(int fd, void* buf, size_t len)
+{
+	ssize_t status;
+	char* data = buf;
+
+	while (len > 0) {
+		status = recv(fd, data, len, 0);
+		if (status < 0 && errno == EINTR)
+			continue;
+		if (status < 0)
+			return -errno;
+		if (status == 0)
+			return -ECONNRESET;
+
+		data += status;
+		len -= status;
+	}
+
+	return 0;
+}
+
+// a word at a time, so that hashing a large corpus takes a fraction of the
+// time it took to parse
+static uint64_t corpus_hash(const struct corpus* corpus)
+{
+	size_t i, len = corpus->len * SUDOKU_SIZE;
+	uint64_t word, hash = 0xcbf29ce484222325ull ^ corpus->len;
+	const uint8_t* data = corpus->puzzles;
+
+	for (i = 0; i + sizeof(word) <= len; i += sizeof(word)) {
+		memcpy(&word, data + i, sizeof(word));
+		hash = (hash ^ word) * 0x100000001b3ull;
+		hash ^= hash >> 29;
+	}
+
+	for (; i < len; ++i)
+		hash = (hash ^ data[i]) * 0x100000001b3ull;
+
+	return hash;
+}
+
+static void identity_set(struct shard_identity* identity,
+	const struct module* module)
+{
+	memset(identity, 0, sizeof(*identity));
+	strncpy(identity->name, module->name, SHARD_STRING_SIZE - 1);
+	strncpy(identity->author, module->author, SHARD_STRING_SIZE - 1);
+}
+
+static int shard_listen(const char* port)
+{
+	int fd = -1, status, one = 1;
+	struct addrinfo hints, *addrs, *addr;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = AI_PASSIVE;
+
+	status = getaddrinfo(NULL, port, &hints, &addrs);
+	if (status != 0) {
+		fprintf(stderr, "invalid port %s: %s\n", port,
+			gai_strerror(status));
+		return -EINVAL;
+	}
+
+	for (addr = addrs; addr; addr = addr->ai_next) {
+		fd = socket(addr->ai_family, addr->ai_socktype | SOCK_CLOEXEC,
+			addr->ai_protocol);
+		if (fd < 0)
+			continue;
+
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+		if (bind(fd, addr->ai_addr, addr->ai_addrlen) == 0
+			&& listen(fd, SOMAXCONN) == 0)
+			break;
+
+		close(fd);
+		fd = -1;
+	}
+
+	freeaddrinfo(addrs);
+	if (fd < 0) {
+		fprintf(stderr, "failed to listen on port %s\n", port);
+		return -EADDRINUSE;
+	}
+
+	return fd;
+}
+
+// the address is given as host:port, with the host's last colon taken as the
+// separator so that ipv6 addresses work unbracketed
+static int shard_connect(const char* address)
+{
+	int fd = -1, status, one = 1;
+	char host[NI_MAXHOST];
+	const char* port = strrchr(address, ':');
+	struct addrinfo hints, *addrs, *addr;
+
+	if (!port || port == address || port - address >= sizeof(host)) {
+		fprintf(stderr, "invalid address: %s\n", address);
+		return -EINVAL;
+	}
+
+	memcpy(host, address, port - address);
+	host[port - address] = '\0';
+	++port;
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+
+	status = getaddrinfo(host, port, &hints, &addrs);
+	if (status != 0) {
+		fprintf(stderr, "invalid address %s: %s\n", address,
+			gai_strerror(status));
+		return -EINVAL;
+	}
+
+	for (addr = addrs; addr; addr = addr->ai_next) {
+		fd = socket(addr->ai_family, addr->ai_socktype | SOCK_CLOEXEC,
+			addr->ai_protocol);
+		if (fd < 0)
+			continue;
+
+		if (connect(fd, addr->ai_addr, addr->ai_addrlen) == 0)
+			break;
+
+		close(fd);
+		fd = -1;
+	}
+
+	freeaddrinfo(addrs);
+	if (fd < 0) {
+		fprintf(stderr, "failed to connect to %s\n", address);
+		return -ECONNREFUSED;
+	}
+
+	// ranges are tiny and shouldn't wait on the previous report's acks
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	return fd;
+}
+
+// shards given up by lost workers go out again before any new ones. once
+// there's nothing left to hand out, a worker is held until every shard is in
+// rather than released, as any shard still out may yet be requeued
+static bool coordinator_take(struct coordinator* coordinator,
+	struct shard_range* range)
+{
+	bool taken = true;
+	size_t len = coordinator->corpus->len;
+
+	pthread_mutex_lock(&coordinator->lock);
+	while (coordinator->retries_len == 0 && coordinator->next >= len
+		&& atomic_load(&coordinator->completed) < len
+		&& !coordinator->stopped)
+		pthread_cond_wait(&coordinator->changed, &coordinator->lock);
+
+	if (coordinator->retries_len > 0) {
+		*range = coordinator->retries[--coordinator->retries_len];
+	} else if (coordinator->next < len) {
+		range->begin = coordinator->next;
+		range->end = len - range->begin > coordinator->shard_size
+			? range->begin + coordinator->shard_size : len;
+		coordinator->next = range->end;
+	} else {
+		range->begin = range->end = 0;
+		taken = false;
+	}
+
+	pthread_mutex_unlock(&coordinator->lock);
+	return taken;
+}
+
+// there are never more retries than shards, which the array is sized for
+static void coordinator_retry(struct coordinator* coordinator,
+	const struct shard_range* range)
+{
+	pthread_mutex_lock(&coordinator->lock);
+	coordinator->retries[coordinator->retries_len++] = *range;
+	pthread_cond_broadcast(&coordinator->changed);
+	pthread_mutex_unlock(&coordinator->lock);
+}
+
+static void coordinator_merge(struct coordinator* coordinator,
+	const struct shard_report* reports, const struct shard_range* range)
+{
+	int i, k;
+
+	pthread_mutex_lock(&coordinator->lock);
+	for (i = 0; i < coordinator->modules; ++i) {
+		struct result* result = &coordinator->results[i];
+		const struct shard_report* report = &reports[i];
+
+		histogram_merge(result->histogram, &report->histogram);
+		result->elapsed += report->elapsed;
+		result->tally.tested += report->tested;
+		result->tally.incorrect += report->incorrect;
+		result->tally.timeouts += report->timeouts;
+		effort_merge(&result->effort, &report->effort);
+
+		if (report->counted == 0)
+			continue;
+
+		result->available = report->available;
+		for (k = 0; k < PERF_COUNTERS; ++k)
+			result->counters[k] += report->counters[k];
+
+		result->counted += report->counted;
+	}
+
+	atomic_fetch_add(&coordinator->completed, range->end - range->begin);
+	pthread_cond_broadcast(&coordinator->changed);
+	pthread_mutex_unlock(&coordinator->lock);
+}
+
+static int coordinator_greet(struct connection* connection,
+	struct shard_identity* identities)
+{
+	int status, i;
+	struct shard_hello hello;
+	struct shard_identity expected;
+	struct coordinator* coordinator = connection->coordinator;
+	const struct config* config = coordinator->config;
+	struct shard_plan plan = {
+		.batch = config->batch,
+		.warmup = config->warmup,
+		.repeat = config->repeat,
+		.reduce = config->reduce,
+		.schedule = config->schedule,
+		.seed = config->seed,
+		.timeout = config->timeout,
+		.perf = config->perf,
+		.effort = config->effort,
+	};
+
+	status = shard_recv(connection->fd, &hello, sizeof(hello));
+	if (status < 0)
+		return status;
+
+	if (hello.magic != SHARD_MAGIC) {
+		fprintf(stderr, "%s: not a worker\n", connection->peer);
+		return -EPROTO;
+	}
+
+	if (hello.puzzles != coordinator->corpus->len
+		|| hello.hash != coordinator->hash) {
+		fprintf(stderr, "%s: corpus doesn't match\n",
+			connection->peer);
+		return -EPROTO;
+	}
+
+	if (hello.modules != coordinator->modules) {
+		fprintf(stderr, "%s: modules don't match\n", connection->peer);
+		return -EPROTO;
+	}
+
+	status = shard_recv(connection->fd, identities,
+		sizeof(*identities) * coordinator->modules);
+	if (status < 0)
+		return status;
+
+	for (i = 0; i < coordinator->modules; ++i) {
+		identity_set(&expected, &coordinator->results[i].module);
+		if (memcmp(&expected, &identities[i], sizeof(expected)) != 0) {
+			fprintf(stderr, "%s: modules don't match\n",
+				connection->peer);
+			return -EPROTO;
+		}
+	}
+
+	return shard_send(connection->fd, &plan, sizeof(plan));
+}
+
+static void* coordinator_serve(void* arg)
+{
+	int status;
+	struct shard_range range;
+	struct connection* connection = arg;
+	struct coordinator* coordinator = connection->coordinator;
+	struct shard_identity* identities;
+	struct shard_report* reports;
+
+	identities = calloc(coordinator->modules, sizeof(*identities));
+	reports = malloc(sizeof(*reports) * coordinator->modules);
+	if (!identities || !reports) {
+		fputs("failed to allocate reports\n", stderr);
+		goto out;
+	}
+
+	if (coordinator_greet(connection, identities) < 0)
+		goto out;
+
+	fprintf(stderr, "%s: worker connected\n", connection->peer);
+	for (;;) {
+		bool taken = coordinator_take(coordinator, &range);
+
+		status = shard_send(connection->fd, &range, sizeof(range));
+		if (status == 0 && taken)
+			status = shard_recv(connection->fd, reports,
+				sizeof(*reports) * coordinator->modules);
+
+		if (status < 0 && taken) {
+			fprintf(stderr, "%s: worker lost, shard %zu-%zu "
+				"requeued\n", connection->peer,
+				(size_t)range.begin, (size_t)range.end);
+			coordinator_retry(coordinator, &range);
+		}
+
+		if (status < 0 || !taken)
+			break;
+
+		coordinator_merge(coordinator, reports, &range);
+	}
+
+out:
+	free(identities);
+	free(reports);
+	close(connection->fd);
+	return NULL;
+}
+
+// a dead machine is noticed through keepalives, and with --timeout a worker
+// that's alive but stuck is given up on once its shard has had longer than
+// every solve in it could take one after another
+static void connection_limit(int fd, const struct config* config,
+	size_t shard_size, size_t modules)
+{
+	int one = 1, idle = SHARD_KEEPALIVE_IDLE_S;
+	int interval = SHARD_KEEPALIVE_INTERVAL_S;
+	int count = SHARD_KEEPALIVE_COUNT;
+	uint64_t ms;
+	struct timeval limit;
+
+	setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+	setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &idle, sizeof(idle));
+	setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval,
+		sizeof(interval));
+	setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &count, sizeof(count));
+
+	if (config->timeout == 0)
+		return;
+
+	ms = (config->timeout / 1000000) * shard_size * modules
+		* (config->warmup + config->repeat) + SHARD_REPORT_SLACK_MS;
+	limit.tv_sec = ms / 1000;
+	limit.tv_usec = (ms % 1000) * 1000;
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &limit, sizeof(limit));
+}
+
+static void connection_name(struct connection* connection,
+	const struct sockaddr* addr, socklen_t len)
+{
+	char host[NI_MAXHOST], serv[NI_MAXSERV];
+
+	if (getnameinfo(addr, len, host, sizeof(host), serv, sizeof(serv),
+		NI_NUMERICHOST | NI_NUMERICSERV) != 0)
+		strcpy(connection->peer, "unknown");
+	else
+		snprintf(connection->peer, sizeof(connection->peer), "%s:%s",
+			host, serv);
+}
+
+// workers are accepted for as long as any of the corpus is unaccounted for,
+// so one that joins late, or replaces a lost one, still gets to help
+int shard_coordinate(const struct config* config, const struct corpus* corpus,
+	struct result* results, char* const* filenames, size_t modules,
+	const char* port, size_t shard_size)
+{
+	int status = 0, listener, fd, i, one = 1;
+	size_t shards, connections_len = 0, connections_cap = 0;
+	struct sockaddr_storage addr;
+	socklen_t addr_len;
+	struct pollfd pollfd;
+	struct connection** connections = NULL;
+	struct coordinator coordinator = {
+		.config = config,
+		.corpus = corpus,
+		.shard_size = shard_size,
+		.results = results,
+		.modules = modules,
+	};
+
+	// the modules are only loaded for their names, to check the workers'
+	dlerror();
+	for (i = 0; i < modules; ++i) {
+		status = module_init(&results[i].module, filenames[i]);
+		if (status < 0) {
+			fprintf(stderr,
+				"failed to load module: %s\n", filenames[i]);
+			return status;
+		}
+	}
+
+	shards = (corpus->len + shard_size - 1) / shard_size;
+	coordinator.retries = malloc(sizeof(struct shard_range) * shards);
+	if (!coordinator.retries) {
+		fputs("failed to allocate shards\n", stderr);
+		return -ENOMEM;
+	}
+
+	coordinator.hash = corpus_hash(corpus);
+	pthread_mutex_init(&coordinator.lock, NULL);
+	pthread_cond_init(&coordinator.changed, NULL);
+
+	listener = shard_listen(port);
+	if (listener < 0) {
+		free(coordinator.retries);
+		return listener;
+	}
+
+	fprintf(stderr, "coordinating %zu shards on port %s\n", shards, port);
+	pollfd.fd = listener;
+	pollfd.events = POLLIN;
+	while (atomic_load(&coordinator.completed) < corpus->len) {
+		struct connection* connection;
+
+		status = poll(&pollfd, 1, SHARD_POLL_MS);
+		if (status < 0 && errno == EINTR)
+			continue;
+		if (status < 0) {
+			fputs("failed to wait for workers\n", stderr);
+			status = -errno;
+			break;
+		}
+
+		status = 0;
+		if (!(pollfd.revents & POLLIN))
+			continue;
+
+		addr_len = sizeof(addr);
+		fd = accept4(listener, (struct sockaddr*)&addr, &addr_len,
+			SOCK_CLOEXEC);
+		if (fd < 0)
+			continue;
+
+		// a worker whose machine went away, or that stops reporting,
+		// is given up on and its shard handed out again
+		connection_limit(fd, config, shard_size, modules);
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+		if (connections_len == connections_cap) {
+			struct connection** grown;
+
+			connections_cap = connections_cap ? connections_cap * 2
+				: 16;
+			grown = realloc(connections,
+				sizeof(*connections) * connections_cap);
+			if (!grown) {
+				fputs("failed to allocate connection\n",
+					stderr);
+				close(fd);
+				status = -ENOMEM;
+				break;
+			}
+
+			connections = grown;
+		}
+
+		connection = malloc(sizeof(*connection));
+		if (!connection) {
+			fputs("failed to allocate connection\n", stderr);
+			close(fd);
+			status = -ENOMEM;
+			break;
+		}
+
+		connection->coordinator = &coordinator;
+		connection->fd = fd;
+		connection_name(connection, (struct sockaddr*)&addr, addr_len);
+		status = pthread_create(&connection->thread, NULL,
+			coordinator_serve, connection);
+		if (status != 0) {
+			fputs("failed to start connection\n", stderr);
+			close(fd);
+			free(connection);
+			status = -status;
+			break;
+		}
+
+		connections[connections_len++] = connection;
+	}
+
+	// every connection still open is either held, and released here, or is
+	// finishing the last shards, so the joins don't wait for long
+	close(listener);
+	pthread_mutex_lock(&coordinator.lock);
+	coordinator.stopped = true;
+	pthread_cond_broadcast(&coordinator.changed);
+	pthread_mutex_unlock(&coordinator.lock);
+	for (i = 0; i < connections_len; ++i) {
+		pthread_join(connections[i]->thread, NULL);
+		free(connections[i]);
+	}
+
+	free(connections);
+	free(coordinator.retries);
+	pthread_cond_destroy(&coordinator.changed);
+	pthread_mutex_destroy(&coordinator.lock);
+	return status;
+}
+
+static int worker_greet(int fd, struct config* config,
+	const struct corpus* corpus, const struct result* results,
+	size_t modules)
+{
+	int status, i;
+	struct shard_plan plan;
+	struct shard_identity identity;
+	struct shard_hello hello = {
+		.magic = SHARD_MAGIC,
+		.puzzles = corpus->len,
+		.hash = corpus_hash(corpus),
+		.modules = modules,
+	};
+
+	status = shard_send(fd, &hello, sizeof(hello));
+	for (i = 0; status == 0 && i < modules; ++i) {
+		identity_set(&identity, &results[i].module);
+		status = shard_send(fd, &identity, sizeof(identity));
+	}
+
+	if (status == 0)
+		status = shard_recv(fd, &plan, sizeof(plan));
+
+	if (status < 0) {
+		fputs("rejected by the coordinator, see its log\n", stderr);
+		return status;
+	}
+
+	config->batch = plan.batch;
+	config->warmup = plan.warmup;
+	config->repeat = plan.repeat;
+	config->reduce = plan.reduce;
+	config->schedule = plan.schedule;
+	config->seed = plan.seed;
+	config->timeout = plan.timeout;
+	config->perf = plan.perf;
+	config->effort = plan.effort;
+	return 0;
+}
+
+// the results are emptied after every shard, keeping their allocations,
+// which only grow if a shard is larger than any before it
+static int worker_shard(const struct config* config,
+	const struct corpus* corpus, const struct shard_range* range,
+	struct result* results, struct shard_report* reports, size_t modules)
+{
+	int status, i, k;
+	size_t n, len = range->end - range->begin;
+	struct config local = *config;
+	struct worker* workers;
+	struct corpus view = {
+		.puzzles = corpus_get(corpus, range->begin),
+		.len = len,
+		.cap = len,
+	};
+
+	if (local.threads > len)
+		local.threads = len;
+
+	for (i = 0; i < modules; ++i) {
+		struct samples* samples = &results[i].samples;
+
+		if (samples->cap < len) {
+			free(samples->data);
+			samples->data = aligned_alloc(CACHE_LINE_SIZE,
+				ALIGN_UP(sizeof(uint64_t) * len,
+					CACHE_LINE_SIZE));
+			samples->cap = samples->data ? len : 0;
+			if (!samples->data) {
+				fputs("failed to allocate results\n", stderr);
+				return -ENOMEM;
+			}
+		}
+
+		samples->len = 0;
+		results[i].elapsed = 0;
+		memset(&results[i].tally, 0, sizeof(results[i].tally));
+		memset(results[i].counters, 0, sizeof(results[i].counters));
+		results[i].counted = 0;
+		memset(&results[i].effort, 0, sizeof(results[i].effort));
+	}
+
+	workers = aligned_alloc(CACHE_LINE_SIZE,
+		sizeof(struct worker) * local.threads);
+	if (!workers) {
+		fputs("failed to allocate workers\n", stderr);
+		return -ENOMEM;
+	}
+
+	status = workers_run(workers, &local, &view, results, modules);
+	if (status == 0)
+		status = workers_merge(workers, local.threads, results,
+			modules);
+
+	free(workers);
+	if (status < 0)
+		return status;
+
+	for (i = 0; i < modules; ++i) {
+		struct shard_report* report = &reports[i];
+		const struct result* result = &results[i];
+		const struct clock_source* clock = &config->clock;
+
+		report->tested = result->tally.tested;
+		report->incorrect = result->tally.incorrect;
+		report->timeouts = result->tally.timeouts;
+		report->elapsed = clock_to_ns(clock, result->elapsed);
+		report->available = result->available;
+		report->counted = result->counted;
+		report->effort = result->effort;
+		for (k = 0; k < PERF_COUNTERS; ++k)
+			report->counters[k] = result->counters[k];
+
+		histogram_reset(&report->histogram);
+		for (n = 0; n < result->samples.len; ++n)
+			histogram_add(&report->histogram,
+				clock_to_ns(clock, result->samples.data[n]));
+	}
+
+	return 0;
+}
+
+int shard_work(struct config* config, const struct corpus* corpus,
+	char* const* filenames, size_t modules, const char* address)
+{
+	int status, fd, i;
+	size_t shards = 0;
+	struct shard_range range;
+	struct result* results;
+	struct shard_report* reports;
+
+	results = aligned_alloc(CACHE_LINE_SIZE,
+		sizeof(struct result) * modules);
+	reports = malloc(sizeof(*reports) * modules);
+	if (!results || !reports) {
+		fputs("failed to allocate results\n", stderr);
+		return -ENOMEM;
+	}
+
+	memset(results, 0, sizeof(struct result) * modules);
+	dlerror();
+	for (i = 0; i < modules; ++i) {
+		status = module_init(&results[i].module, filenames[i]);
+		if (status < 0) {
+			fprintf(stderr,
+				"failed to load module: %s\n", filenames[i]);
+			return status;
+		}
+	}
+
+	fd = shard_connect(address);
+	if (fd < 0)
+		return fd;
+
+	status = worker_greet(fd, config, corpus, results, modules);
+	if (status < 0)
+		goto out;
+
+	for (;;) {
+		status = shard_recv(fd, &range, sizeof(range));
+		if (status < 0 || range.begin == range.end)
+			break;
+
+		if (range.begin > range.end || range.end > corpus->len) {
+			fputs("invalid shard from the coordinator\n", stderr);
+			status = -EPROTO;
+			goto out;
+		}
+
+		status = worker_shard(config, corpus, &range, results, reports,
+			modules);
+		if (status < 0)
+			goto out;
+
+		status = shard_send(fd, reports, sizeof(*reports) * modules);
+		if (status < 0)
+			break;
+
+		++shards;
+	}
+
+	if (status < 0)
+		fputs("lost the coordinator\n", stderr);
+	else
+		fprintf(stderr, "tested %zu shards\n", shards);
+
+out:
+	close(fd);
+	for (i = 0; i < modules; ++i)
+		free(results[i].samples.data);
+
+	free(results);
+	free(reports);
+	return status;
+}
@@ -0,0 +1,36 @@
+// Sudoku Master Sharding
+//
+// Author: Matthew Knight
+// File Name: shard.h
+// Date: 2026-10-14
+//
+// A run can be spread over several machines. The coordinator listens on a tcp
+// port and splits the corpus into shards, ranges of puzzle indices, which it
+// hands out to workers as they connect and finish the shards before. Workers
+// load the same corpus file themselves, usually from shared storage, so only
+// the shard's bounds go over the network. A worker that drops its connection
+// has its shard handed to the next worker that asks.
+//
+// Each worker times its shard in its own clock, and sends back its samples
+// counted into a histogram of nanoseconds together with the tallies, so the
+// merged report has the same columns as a run on one machine. The counts are
+// identical to a run on one machine, the mean and spread are exact, and the
+// quantiles are within the histogram's accuracy.
+
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <stddef.h>
+
+#include "corpus.h"
+#include "runner.h"
+
+#define SHARD_DEFAULT_SIZE (1 << 18)
+
+int shard_coordinate(const struct config* config, const struct corpus* corpus,
+	struct result* results, char* const* filenames, size_t modules,
+	const char* port, size_t shard_size);
+int shard_work(struct config* config, const struct corpus* corpus,
+	char* const* filenames, size_t modules, const char* address);
+
+#endif
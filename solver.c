@@ -0,0 +1,263 @@
+// Sudoku Master Reference Solver
+//
+// Author: Matthew Knight
+// File Name: solver.c
+// Date: 2026-10-14
+//
+// Candidates are kept as a 9 bit mask of the digits already used by each row,
+// column and box. Naked singles are placed until none are left, then hidden
+// singles are found per unit by folding the candidates of its cells into
+// masks of digits seen once and seen twice. When propagation stalls the search
+// branches on the empty cell with the fewest candidates, on a copy of the
+// state, so there is nothing to undo on the way back out.
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "solver.h"
+#include "tables.h"
+
+#define ALL_DIGITS 0x1ff
+
+#define SOLVER_SOLVED -1
+#define SOLVER_CONTRADICTION -2
+
+struct solver {
+    uint8_t grid[SUDOKU_SIZE];
+    uint16_t rows[SUDOKU_AXIS_SIZE];
+    uint16_t cols[SUDOKU_AXIS_SIZE];
+    uint16_t boxes[SUDOKU_AXIS_SIZE];
+};
+
+struct search {
+    uint8_t* first;
+    size_t limit;
+    size_t solutions;
+    uint64_t nodes;
+    struct solver_stats stats;
+    bool aborted;
+};
+
+static inline unsigned candidates(const struct solver* s, int cell)
+{
+	const struct cell_units* at = &cell_units[cell];
+
+	return ~(s->rows[at->row] | s->cols[at->col] | s->boxes[at->box])
+		& ALL_DIGITS;
+}
+
+// digit is 0 based
+static inline void place(struct solver* s, int cell, int digit)
+{
+	unsigned bit = 1u << digit;
+	const struct cell_units* at = &cell_units[cell];
+
+	s->grid[cell] = digit + 1;
+	s->rows[at->row] |= bit;
+	s->cols[at->col] |= bit;
+	s->boxes[at->box] |= bit;
+}
+
+static int solver_init(struct solver* s, const uint8_t* grid)
+{
+	int cell;
+
+	memset(s, 0, sizeof(*s));
+	for (cell = 0; cell < SUDOKU_SIZE; ++cell) {
+		if (grid[cell] == 0)
+			continue;
+
+		if (grid[cell] > 9
+			|| !(candidates(s, cell) & (1u << (grid[cell] - 1))))
+			return SOLVER_CONTRADICTION;
+
+		place(s, cell, grid[cell] - 1);
+	}
+
+	return 0;
+}
+
+// places every single it can find, and returns the empty cell with the fewest
+// candidates once there are none left
+static int solver_propagate(struct solver* s, uint64_t* placements)
+{
+	int cell, unit, k, best, min, count;
+	unsigned cand, once, twice, placed, hidden, bit;
+	bool progress;
+
+	do {
+		progress = false;
+		best = SOLVER_SOLVED;
+		min = SUDOKU_AXIS_SIZE + 1;
+
+		for (cell = 0; cell < SUDOKU_SIZE; ++cell) {
+			if (s->grid[cell] != 0)
+				continue;
+
+			cand = candidates(s, cell);
+			if (cand == 0)
+				return SOLVER_CONTRADICTION;
+
+			if ((cand & (cand - 1)) == 0) {
+				place(s, cell, __builtin_ctz(cand));
+				++*placements;
+				progress = true;
+				continue;
+			}
+
+			count = __builtin_popcount(cand);
+			if (count < min) {
+				min = count;
+				best = cell;
+			}
+		}
+
+		if (progress)
+			continue;
+
+		for (unit = 0; unit < SUDOKU_UNITS; ++unit) {
+			once = twice = placed = 0;
+			for (k = 0; k < SUDOKU_AXIS_SIZE; ++k) {
+				cell = units[unit][k];
+				if (s->grid[cell] != 0) {
+					placed |= 1u << (s->grid[cell] - 1);
+					continue;
+				}
+
+				cand = candidates(s, cell);
+				twice |= once & cand;
+				once |= cand;
+			}
+
+			// a digit with nowhere left to go
+			if ((once | placed) != ALL_DIGITS)
+				return SOLVER_CONTRADICTION;
+
+			for (hidden = once & ~twice; hidden;
+				hidden &= hidden - 1) {
+				bit = hidden & -hidden;
+				for (k = 0; k < SUDOKU_AXIS_SIZE; ++k) {
+					cell = units[unit][k];
+					if (s->grid[cell] == 0
+						&& (candidates(s, cell) & bit))
+						break;
+				}
+
+				// two hidden singles on the same cell
+				if (k == SUDOKU_AXIS_SIZE)
+					return SOLVER_CONTRADICTION;
+
+				place(s, cell, __builtin_ctz(bit));
+				++*placements;
+				progress = true;
+			}
+		}
+	} while (progress);
+
+	return best;
+}
+
+static void solver_search(struct solver* s, struct search* search)
+{
+	int cell;
+	unsigned cand;
+	struct solver next;
+
+	++search->stats.nodes;
+	cell = solver_propagate(s, &search->stats.propagations);
+	if (cell == SOLVER_CONTRADICTION)
+		return;
+
+	if (cell == SOLVER_SOLVED) {
+		if (search->solutions++ == 0)
+			memcpy(search->first, s->grid, SUDOKU_SIZE);
+
+		return;
+	}
+
+	if (++search->nodes > SOLVER_NODE_LIMIT) {
+		search->aborted = true;
+		return;
+	}
+
+	for (cand = candidates(s, cell); cand; cand &= cand - 1) {
+		next = *s;
+		place(&next, cell, __builtin_ctz(cand));
+		++search->stats.guesses;
+		solver_search(&next, search);
+		if (search->solutions >= search->limit || search->aborted)
+			return;
+
+		++search->stats.backtracks;
+	}
+}
+
+// returns the number of solutions found, up to limit
+int solver_solve(uint8_t* grid, size_t limit)
+{
+	return solver_solve_counted(grid, limit, NULL);
+}
+
+// the same, adding the bitmask search's effort to stats. a puzzle handed over
+// to dancing links only counts the effort up to the hand over
+int solver_solve_counted(uint8_t* grid, size_t limit,
+	struct solver_stats* stats)
+{
+	struct solver s;
+	uint8_t solution[SUDOKU_SIZE];
+	struct search search = {
+		.first = solution,
+		.limit = limit,
+	};
+
+	if (solver_init(&s, grid) < 0)
+		return 0;
+
+	solver_search(&s, &search);
+	if (stats) {
+		stats->nodes += search.stats.nodes;
+		stats->guesses += search.stats.guesses;
+		stats->backtracks += search.stats.backtracks;
+		stats->propagations += search.stats.propagations;
+	}
+
+	if (search.aborted)
+		return dlx_solve(grid, limit);
+
+	if (search.solutions > 0)
+		memcpy(grid, solution, SUDOKU_SIZE);
+
+	return search.solutions;
+}
+
+// returns -1 for a puzzle without a solution, which is rated all the same
+int solver_rate(const uint8_t* puzzle, struct difficulty* difficulty)
+{
+	int cell;
+	struct solver s, singles;
+	uint8_t solution[SUDOKU_SIZE];
+	struct search search = {
+		.first = solution,
+		.limit = 1,
+	};
+
+	memset(difficulty, 0, sizeof(*difficulty));
+	for (cell = 0; cell < SUDOKU_SIZE; ++cell)
+		if (puzzle[cell] != 0)
+			++difficulty->givens;
+
+	if (solver_init(&s, puzzle) < 0)
+		return -1;
+
+	singles = s;
+	solver_propagate(&singles, &search.stats.propagations);
+	for (cell = 0; cell < SUDOKU_SIZE; ++cell)
+		if (singles.grid[cell] != 0)
+			++difficulty->singles;
+
+	difficulty->singles -= difficulty->givens;
+
+	solver_search(&s, &search);
+	difficulty->nodes = search.nodes;
+	return search.solutions > 0 ? 0 : -1;
+}
@@ -0,0 +1,38 @@
+// Sudoku Master Reference Solver
+//
+// Author: Matthew Knight
+// File Name: solver.h
+// Date: 2026-10-14
+//
+// The harness's own solver, used to establish ground truth for the corpus and
+// as a baseline for the modules. Both solvers count solutions up to a limit,
+// and leave the first one they find in the grid.
+
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "solver_stats.h"
+
+// the bitmask search hands a puzzle over to dancing links past this many
+// branches
+#define SOLVER_NODE_LIMIT 100000
+
+// cheap features of how hard a puzzle is for the reference solver: singles are
+// the cells filled by propagation alone before the first branch, and nodes is
+// how many branches it then took to find a solution
+struct difficulty {
+    int givens;
+    int singles;
+    uint64_t nodes;
+};
+
+int solver_solve(uint8_t* grid, size_t limit);
+int solver_solve_counted(uint8_t* grid, size_t limit,
+	struct solver_stats* stats);
+int solver_rate(const uint8_t* puzzle, struct difficulty* difficulty);
+int dlx_solve(uint8_t* grid, size_t limit);
+
+#endif
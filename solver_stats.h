@@ -0,0 +1,34 @@
+// Sudoku Master Solver Statistics
+//
+// Author: Matthew Knight
+// File Name: solver_stats.h
+// Date: 2026-10-14
+//
+// The optional search effort ABI, and the one header a module may include. A
+// module that exports
+//
+//     struct solver_stats solver_stats;
+//
+// adds to its counts as it solves, and the harness reads them around every
+// timed solve to work out how much searching each one took. The counts are
+// only ever added to, and are never reset by the module. A module that solves
+// on several threads at once declares it with __thread, and each of the
+// harness's workers reads its own thread's copy.
+
+#ifndef SOLVER_STATS_H
+#define SOLVER_STATS_H
+
+#include <stdint.h>
+
+struct solver_stats {
+    // search states entered, whether by a guess or at the top of a solve
+    uint64_t nodes;
+    // candidates tried on a cell that had more than one
+    uint64_t guesses;
+    // guesses that were taken back
+    uint64_t backtracks;
+    // digits placed by deduction rather than by guessing
+    uint64_t propagations;
+};
+
+#endif
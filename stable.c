@@ -0,0 +1,220 @@
+// Sudoku Master Stable Mode
+//
+// Author: Matthew Knight
+// File Name: stable.c
+// Date: 2026-10-14
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "stable.h"
+
+#define CPU_SYSFS "/sys/devices/system/cpu"
+
+// the first line of a sysfs file, without its newline
+static int sysfs_read(const char* path, char* buf, size_t len)
+{
+	FILE* file = fopen(path, "r");
+
+	if (!file)
+		return -errno;
+
+	if (!fgets(buf, len, file)) {
+		fclose(file);
+		return -EIO;
+	}
+
+	fclose(file);
+	buf[strcspn(buf, "\n")] = '\0';
+	return 0;
+}
+
+static long sysfs_long(const char* path)
+{
+	char buf[STABLE_STRING_SIZE];
+
+	if (sysfs_read(path, buf, sizeof(buf)) < 0)
+		return -1;
+
+	return strtol(buf, NULL, 10);
+}
+
+// whether cpu appears in a list like 2-5,7
+static bool cpu_listed(const char* list, int cpu)
+{
+	long first, last;
+	char* end;
+
+	while (*list) {
+		first = last = strtol(list, &end, 10);
+		if (end == list)
+			return false;
+
+		if (*end == '-')
+			last = strtol(end + 1, &end, 10);
+
+		if (cpu >= first && cpu <= last)
+			return true;
+
+		list = *end == ',' ? end + 1 : end;
+	}
+
+	return false;
+}
+
+// intel_pstate reports whether turbo is disabled, acpi-cpufreq whether boost
+// is enabled
+static int boost_state(void)
+{
+	long val;
+
+	val = sysfs_long(CPU_SYSFS "/intel_pstate/no_turbo");
+	if (val >= 0)
+		return !val;
+
+	return sysfs_long(CPU_SYSFS "/cpufreq/boost");
+}
+
+static bool tsc_invariant(void)
+{
+	bool constant = false, nonstop = false;
+	char line[4096];
+	FILE* file = fopen("/proc/cpuinfo", "r");
+
+	if (!file)
+		return false;
+
+	while (fgets(line, sizeof(line), file)) {
+		if (strncmp(line, "flags", 5) != 0)
+			continue;
+
+		constant = strstr(line, " constant_tsc") != NULL;
+		nonstop = strstr(line, " nonstop_tsc") != NULL;
+		break;
+	}
+
+	fclose(file);
+	return constant && nonstop;
+}
+
+static long cpufreq_long(int cpu, const char* name)
+{
+	char path[128];
+
+	snprintf(path, sizeof(path), CPU_SYSFS "/cpu%d/cpufreq/%s", cpu, name);
+	return sysfs_long(path);
+}
+
+static void environment_read(struct environment* env)
+{
+	char path[128], list[256];
+
+	if (sysfs_read(CPU_SYSFS "/isolated", list, sizeof(list)) == 0)
+		env->isolated = cpu_listed(list, env->cpu);
+
+	snprintf(path, sizeof(path), CPU_SYSFS "/cpu%d/cpufreq/%s", env->cpu,
+		"scaling_governor");
+	if (sysfs_read(path, env->governor, sizeof(env->governor)) < 0)
+		env->governor[0] = '\0';
+
+	env->frequency = cpufreq_long(env->cpu, "scaling_cur_freq");
+	env->min_frequency = cpufreq_long(env->cpu, "scaling_min_freq");
+	env->max_frequency = cpufreq_long(env->cpu, "scaling_max_freq");
+	env->boost = boost_state();
+	env->invariant_tsc = tsc_invariant();
+}
+
+// the harness runs one below the highest priority, leaving room above it for
+// the watchdog
+int stable_enter(struct environment* env, int cpu)
+{
+	cpu_set_t set;
+	struct sched_param param = { 0 };
+
+	memset(env, 0, sizeof(*env));
+	env->cpu = cpu;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	if (sched_setaffinity(0, sizeof(set), &set) < 0) {
+		fprintf(stderr, "failed to pin to cpu %d: %s\n", cpu,
+			strerror(errno));
+		return -errno;
+	}
+
+	environment_read(env);
+	if (!env->isolated)
+		fprintf(stderr, "warning: cpu %d isn't isolated\n", cpu);
+
+	param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+	if (sched_setscheduler(0, SCHED_FIFO, &param) == 0)
+		env->fifo = true;
+	else
+		fprintf(stderr, "warning: can't run under SCHED_FIFO: %s\n",
+			strerror(errno));
+
+	if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+		env->locked = true;
+	else
+		fprintf(stderr, "warning: can't lock memory: %s\n",
+			strerror(errno));
+
+	return 0;
+}
+
+// writes to a byte of every page, for when the memory couldn't be locked, or
+// was calloc'd and is still backed by the shared zero page
+void stable_prefault(void* data, size_t len)
+{
+	size_t i;
+	long page = sysconf(_SC_PAGESIZE);
+	volatile char* bytes = data;
+
+	for (i = 0; i < len; i += page)
+		bytes[i] = bytes[i];
+}
+
+static void print_field(const char* key, const char* value)
+{
+	printf("# %s:%s%s\n", key, *value ? " " : "", value);
+}
+
+// unknown values are left empty
+void stable_print(const struct environment* env,
+	const struct clock_source* clock)
+{
+	char buf[128];
+	double tsc_ghz = clock_tsc_ghz(clock);
+
+	snprintf(buf, sizeof(buf), "%d%s", env->cpu,
+		env->isolated ? " (isolated)" : "");
+	print_field("cpu", buf);
+	print_field("scheduler", env->fifo ? "fifo" : "other");
+	print_field("memory", env->locked ? "locked" : "unlocked");
+	print_field("governor", env->governor);
+
+	buf[0] = '\0';
+	if (env->frequency >= 0)
+		snprintf(buf, sizeof(buf), "%ld kHz (%ld-%ld)", env->frequency,
+			env->min_frequency, env->max_frequency);
+	print_field("frequency", buf);
+	print_field("boost", env->boost < 0 ? "" : env->boost ? "on" : "off");
+
+	buf[0] = '\0';
+	if (tsc_ghz > 0)
+		snprintf(buf, sizeof(buf), "%.6f GHz%s", tsc_ghz,
+			env->invariant_tsc ? " (invariant)" : "");
+	print_field("tsc", buf);
+
+	snprintf(buf, sizeof(buf), "%s, %" PRIu64 " ns overhead", clock->name,
+		clock_to_ns(clock, clock->overhead));
+	print_field("clock", buf);
+}
@@ -0,0 +1,43 @@
+// Sudoku Master Stable Mode
+//
+// Author: Matthew Knight
+// File Name: stable.h
+// Date: 2026-10-14
+//
+// With --stable CPU the harness pins itself to one cpu, ideally one kept free
+// of other work with isolcpus, runs under SCHED_FIFO when it's allowed to, and
+// locks its memory so that nothing it touches during a run is faulted in or
+// swapped out. Whatever couldn't be done is warned about rather than failing
+// the run, and the state of the machine is recorded in the output header, so
+// that runs on different machines, or in different conditions, can be told
+// apart.
+
+#ifndef STABLE_H
+#define STABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "timing.h"
+
+#define STABLE_STRING_SIZE 32
+
+struct environment {
+    int cpu;
+    bool isolated;
+    bool fifo;
+    bool locked;
+    char governor[STABLE_STRING_SIZE];
+    long frequency;
+    long min_frequency;
+    long max_frequency;
+    int boost;
+    bool invariant_tsc;
+};
+
+int stable_enter(struct environment* env, int cpu);
+void stable_prefault(void* data, size_t len);
+void stable_print(const struct environment* env,
+	const struct clock_source* clock);
+
+#endif
@@ -0,0 +1,204 @@
+// Sudoku Master Statistics
+//
+// Author: Matthew Knight
+// File Name: stats.c
+// Date: 2026-10-14
+//
+// Sorting is an lsd radix sort over 16 bit digits, so a run's samples are
+// sorted in at most four linear passes. Passes where every sample shares the
+// same digit, which is most of them for durations, are skipped.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "stats.h"
+
+int samples_sort(struct samples* samples)
+{
+	int shift;
+	size_t i, *counts, sum, count;
+	uint64_t *src = samples->data, *dst, *tmp;
+
+	if (samples->len < 2)
+		return 0;
+
+	dst = malloc(sizeof(uint64_t) * samples->len);
+	counts = malloc(sizeof(size_t) * RADIX_SIZE);
+	if (!dst || !counts) {
+		free(dst);
+		free(counts);
+		return -ENOMEM;
+	}
+
+	for (shift = 0; shift < 64; shift += RADIX_BITS) {
+		memset(counts, 0, sizeof(size_t) * RADIX_SIZE);
+		for (i = 0; i < samples->len; ++i)
+			counts[RADIX_DIGIT(src[i], shift)]++;
+
+		if (counts[RADIX_DIGIT(src[0], shift)] == samples->len)
+			continue;
+
+		for (i = 0, sum = 0; i < RADIX_SIZE; ++i) {
+			count = counts[i];
+			counts[i] = sum;
+			sum += count;
+		}
+
+		for (i = 0; i < samples->len; ++i)
+			dst[counts[RADIX_DIGIT(src[i], shift)]++] = src[i];
+
+		tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	// an odd number of passes leaves the result in the scratch buffer
+	if (src != samples->data) {
+		memcpy(samples->data, src, sizeof(uint64_t) * samples->len);
+		dst = src;
+	}
+
+	free(dst);
+	free(counts);
+	return 0;
+}
+
+// nearest rank quantile of sorted samples
+uint64_t samples_quantile(const struct samples* samples, double q)
+{
+	size_t rank;
+
+	if (samples->len == 0)
+		return 0;
+
+	rank = (size_t)ceil(q * samples->len);
+	return samples->data[rank > 0 ? rank - 1 : 0];
+}
+
+void summary_compute(struct summary* summary, const struct samples* samples)
+{
+	size_t j, len = samples->len;
+	const uint64_t* data = samples->data;
+	struct moments moments;
+
+	memset(summary, 0, sizeof(*summary));
+	if (len == 0)
+		return;
+
+	summary->min = data[0];
+	summary->max = data[len - 1];
+	summary->median = data[len / 2];
+	summary->p90 = samples_quantile(samples, 0.9);
+	summary->p99 = samples_quantile(samples, 0.99);
+	summary->p999 = samples_quantile(samples, 0.999);
+
+	memset(&moments, 0, sizeof(moments));
+	for (j = 0; j < len; ++j)
+		moments_add(&moments, data[j]);
+
+	summary->average = moments.mean;
+	summary->stdev = moments_stdev(&moments);
+}
+
+// chan's update for combining the moments of two disjoint sets of samples
+void moments_merge(struct moments* dst, const struct moments* src)
+{
+	uint64_t len = dst->len + src->len;
+	double delta = src->mean - dst->mean;
+
+	if (src->len == 0)
+		return;
+
+	dst->mean += delta * src->len / len;
+	dst->m2 += src->m2 + delta * delta * dst->len * src->len / len;
+	dst->len = len;
+}
+
+// the sample standard deviation
+double moments_stdev(const struct moments* moments)
+{
+	if (moments->len < 2)
+		return 0;
+
+	return sqrt(moments->m2 / (moments->len - 1));
+}
+
+void histogram_reset(struct histogram* histogram)
+{
+	memset(histogram, 0, sizeof(*histogram));
+	histogram->min = UINT64_MAX;
+}
+
+void histogram_merge(struct histogram* dst, const struct histogram* src)
+{
+	size_t i;
+
+	for (i = 0; i < HISTOGRAM_BUCKETS; ++i)
+		dst->counts[i] += src->counts[i];
+
+	dst->len += src->len;
+	moments_merge(&dst->moments, &src->moments);
+	if (src->min < dst->min)
+		dst->min = src->min;
+	if (src->max > dst->max)
+		dst->max = src->max;
+}
+
+// the midpoint of the bucket holding the nearest rank, clamped to the values
+// actually seen
+uint64_t histogram_quantile(const struct histogram* histogram, double q)
+{
+	int e;
+	size_t i, rank;
+	uint64_t seen = 0, val;
+
+	if (histogram->len == 0)
+		return 0;
+
+	rank = ceil(q * histogram->len);
+	if (rank < 1)
+		rank = 1;
+
+	for (i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+		seen += histogram->counts[i];
+		if (seen >= rank)
+			break;
+	}
+
+	if (i < HISTOGRAM_SUB_BUCKETS) {
+		val = i;
+	} else {
+		e = (i >> HISTOGRAM_SUB_BITS) + HISTOGRAM_SUB_BITS - 1;
+		val = ((uint64_t)(HISTOGRAM_SUB_BUCKETS
+			+ (i & (HISTOGRAM_SUB_BUCKETS - 1)))
+			<< (e - HISTOGRAM_SUB_BITS))
+			+ ((1ull << (e - HISTOGRAM_SUB_BITS)) / 2);
+	}
+
+	if (val < histogram->min)
+		return histogram->min;
+	if (val > histogram->max)
+		return histogram->max;
+
+	return val;
+}
+
+// the same summary as for a full set of samples, except that the quantiles are
+// approximate
+void histogram_summary(struct summary* summary,
+	const struct histogram* histogram)
+{
+	memset(summary, 0, sizeof(*summary));
+	if (histogram->len == 0)
+		return;
+
+	summary->average = histogram->moments.mean;
+	summary->stdev = moments_stdev(&histogram->moments);
+	summary->min = histogram->min;
+	summary->max = histogram->max;
+	summary->median = histogram_quantile(histogram, 0.5);
+	summary->p90 = histogram_quantile(histogram, 0.9);
+	summary->p99 = histogram_quantile(histogram, 0.99);
+	summary->p999 = histogram_quantile(histogram, 0.999);
+}
@@ -0,0 +1,120 @@
+// Sudoku Master Statistics
+//
+// Author: Matthew Knight
+// File Name: stats.h
+// Date: 2026-10-14
+//
+// Samples are appended unsorted while puzzles are being tested, and sorted a
+// single time once the run is over to compute the summary. Where samples can't
+// all be kept, they are counted into a log-linear histogram instead, which
+// takes the same space however many samples it holds. The mean and spread are
+// always accumulated in floating point, one sample at a time.
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct samples {
+    uint64_t* data;
+    size_t len;
+    size_t cap;
+};
+
+// welford's running mean and sum of squared deviations from it, which
+// neither overflows nor cancels the way a sum of squares does
+struct moments {
+    uint64_t len;
+    double mean;
+    double m2;
+};
+
+struct summary {
+    double average;
+    double stdev;
+    uint64_t median;
+    uint64_t min;
+    uint64_t max;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+};
+
+// values below 2^HISTOGRAM_SUB_BITS get a bucket each, and every power of two
+// above is split into 2^HISTOGRAM_SUB_BITS buckets, so quantiles are within
+// about 3% of the true value
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS \
+	((64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+struct histogram {
+    uint64_t counts[HISTOGRAM_BUCKETS];
+    uint64_t len;
+    struct moments moments;
+    uint64_t min;
+    uint64_t max;
+};
+
+#define RADIX_BITS 16
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_DIGIT(val, shift) (((val) >> (shift)) & (RADIX_SIZE - 1))
+
+int samples_sort(struct samples* samples);
+uint64_t samples_quantile(const struct samples* samples, double q);
+void summary_compute(struct summary* summary, const struct samples* samples);
+
+void moments_merge(struct moments* dst, const struct moments* src);
+double moments_stdev(const struct moments* moments);
+
+void histogram_reset(struct histogram* histogram);
+void histogram_merge(struct histogram* dst, const struct histogram* src);
+uint64_t histogram_quantile(const struct histogram* histogram, double q);
+void histogram_summary(struct summary* summary,
+	const struct histogram* histogram);
+
+static inline int samples_append(struct samples* samples, uint64_t val)
+{
+	if (samples->len >= samples->cap)
+		return -ERANGE;
+
+	samples->data[samples->len++] = val;
+	return 0;
+}
+
+static inline void moments_add(struct moments* moments, double val)
+{
+	double delta = val - moments->mean;
+
+	++moments->len;
+	moments->mean += delta / moments->len;
+	moments->m2 += delta * (val - moments->mean);
+}
+
+static inline size_t histogram_bucket(uint64_t val)
+{
+	int e;
+
+	if (val < HISTOGRAM_SUB_BUCKETS)
+		return val;
+
+	e = 63 - __builtin_clzll(val);
+	return ((size_t)(e - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS)
+		+ ((val >> (e - HISTOGRAM_SUB_BITS))
+			& (HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+static inline void histogram_add(struct histogram* histogram, uint64_t val)
+{
+	++histogram->counts[histogram_bucket(val)];
+	++histogram->len;
+	moments_add(&histogram->moments, val);
+	if (val < histogram->min)
+		histogram->min = val;
+	if (val > histogram->max)
+		histogram->max = val;
+}
+
+#endif
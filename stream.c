@@ -0,0 +1,374 @@
+// Sudoku Master Streaming
+//
+// Author: Matthew Knight
+// File Name: stream.c
+// Date: 2026-10-14
+//
+// The ring is single producer, single consumer. The reader parses each line
+// straight into the slot at the head, waiting for the consumer if the ring is
+// full, and only publishes the slot once a grid is complete. The consumer
+// presents the ring to the worker as a corpus of STREAM_SLOTS puzzles, so
+// puzzles are tested in place and never copied. A stream that outlasts the
+// run's budget is cut off, reader and all.
+
+#define _GNU_SOURCE
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "check.h"
+#include "stream.h"
+
+#define STREAM_CHUNK_SIZE (1 << 16)
+#define STREAM_POLL_NS 50000
+
+struct ring {
+    // written by the reader
+    _Atomic size_t head;
+    _Atomic bool done;
+    int status;
+    int fd;
+
+    // written by the consumer
+    _Alignas(CACHE_LINE_SIZE) _Atomic size_t tail;
+
+    _Alignas(CACHE_LINE_SIZE) uint8_t grids[STREAM_SLOTS * SUDOKU_SIZE];
+};
+
+struct window {
+    struct histogram histogram;
+    size_t failed;
+    size_t incorrect;
+    size_t timeouts;
+    uint64_t elapsed;
+};
+
+static void stream_sleep(void)
+{
+	struct timespec req = { .tv_sec = 0, .tv_nsec = STREAM_POLL_NS };
+
+	nanosleep(&req, NULL);
+}
+
+// blocks until the slot at the head is free
+static void ring_reserve(struct ring* ring, size_t head)
+{
+	while (head - atomic_load_explicit(&ring->tail, memory_order_acquire)
+		>= STREAM_SLOTS) {
+		stream_sleep();
+	}
+}
+
+static ssize_t ring_parse(struct ring* ring, struct parser* parser,
+	const char* buf, size_t len, bool eof)
+{
+	int status;
+	size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	const char *cursor = buf, *end = buf + len, *newline;
+
+	while (cursor < end) {
+		newline = memchr(cursor, '\n', end - cursor);
+		if (!newline) {
+			if (!eof)
+				break;
+
+			newline = end;
+		}
+
+		ring_reserve(ring, head);
+
+		status = parser_line(parser,
+			&ring->grids[(head % STREAM_SLOTS) * SUDOKU_SIZE],
+			cursor, newline - cursor);
+		if (status < 0) {
+			fprintf(stderr, "error parsing line %zu\n",
+				parser->line);
+			return status;
+		}
+
+		head += status;
+		atomic_store_explicit(&ring->head, head, memory_order_release);
+
+		cursor = newline < end ? newline + 1 : end;
+	}
+
+	return cursor - buf;
+}
+
+static void* ring_reader(void* arg)
+{
+	ssize_t status, consumed;
+	size_t fill = 0;
+	bool eof = false;
+	char buf[STREAM_CHUNK_SIZE];
+	struct parser parser;
+	struct ring* ring = arg;
+
+	parser_init(&parser);
+	while (!eof) {
+		status = read(ring->fd, buf + fill, sizeof(buf) - fill);
+		if (status < 0) {
+			if (errno == EINTR)
+				continue;
+
+			fputs("error with file\n", stderr);
+			status = -errno;
+			goto out;
+		}
+
+		eof = status == 0;
+		fill += status;
+
+		consumed = ring_parse(ring, &parser, buf, fill, eof);
+		if (consumed < 0) {
+			status = consumed;
+			goto out;
+		}
+
+		if (consumed == 0 && fill == sizeof(buf)) {
+			fprintf(stderr, "error parsing line %zu\n",
+				parser.line + 1);
+			status = -1;
+			goto out;
+		}
+
+		fill -= consumed;
+		memmove(buf, buf + consumed, fill);
+	}
+
+	status = parser_finish(&parser);
+
+out:
+	ring->status = status;
+	atomic_store_explicit(&ring->done, true, memory_order_release);
+	return NULL;
+}
+
+static void stream_emit(const struct config* config, double seconds,
+	const struct result* results, struct window* windows, size_t modules)
+{
+	int i;
+	double throughput;
+	struct summary summary;
+	const struct clock_source* clock = &config->clock;
+
+	for (i = 0; i < modules; ++i) {
+		histogram_summary(&summary, &windows[i].histogram);
+
+		throughput = 0;
+		if (windows[i].elapsed > 0)
+			throughput = (windows[i].histogram.len * 1e9)
+				/ clock_to_ns(clock, windows[i].elapsed);
+
+		printf("%.3f,%s,%s,%zu,%zu,%zu,%zu,%.1f,%zu,%zu,%zu,%zu,%zu,"
+			"%.0f\n",
+			seconds, results[i].module.name,
+			results[i].module.author,
+			(size_t)windows[i].histogram.len, windows[i].failed,
+			windows[i].incorrect, windows[i].timeouts,
+			clock_to_ns_f(clock, summary.average),
+			clock_to_ns(clock, summary.median),
+			clock_to_ns(clock, summary.min),
+			clock_to_ns(clock, summary.max),
+			clock_to_ns(clock, summary.p90),
+			clock_to_ns(clock, summary.p99), throughput);
+
+		histogram_reset(&windows[i].histogram);
+		windows[i].failed = 0;
+		windows[i].incorrect = 0;
+		windows[i].timeouts = 0;
+		windows[i].elapsed = 0;
+	}
+
+	fflush(stdout);
+}
+
+// tests every puzzle in the ring against every module until the input ends,
+// or the budget runs out
+static int stream_consume(const struct config* config, struct ring* ring,
+	struct worker* worker, struct window* windows)
+{
+	int i;
+	bool done, finished, expired = false;
+	size_t tail = 0, head, window = 0, invalid = 0, slot;
+	uint64_t duration, start, now, last;
+	enum outcome outcome;
+	const struct result* results = worker->results;
+	uint64_t interval = config->interval * 1000000;
+
+	start = last = monotonic_ns();
+	if (config->budget > 0)
+		worker->deadline = start + config->budget;
+
+	for (;;) {
+		done = atomic_load_explicit(&ring->done, memory_order_acquire);
+		head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+		while (tail < head) {
+			if (worker_expired(worker)) {
+				expired = true;
+				break;
+			}
+
+			slot = tail % STREAM_SLOTS;
+			if (check(corpus_get(worker->corpus, slot)) < 0) {
+				fprintf(stderr, "skipping invalid puzzle %zu\n",
+					tail);
+				++invalid;
+				goto next;
+			}
+
+			for (i = 0; i < worker->modules; ++i) {
+				if (worker_struck(worker, i))
+					continue;
+
+				outcome = worker_test(worker,
+					&results[i].module, slot, &duration);
+				worker_inspect(worker, &results[i].module,
+					tail, outcome, worker->output);
+				windows[i].elapsed += duration;
+				if (outcome == OUTCOME_SOLVED)
+					histogram_add(&windows[i].histogram,
+						duration);
+				else
+					++windows[i].failed;
+
+				if (outcome == OUTCOME_INCORRECT
+					&& worker->strikes)
+					++worker->strikes[i];
+
+				if (outcome == OUTCOME_INCORRECT)
+					++windows[i].incorrect;
+				else if (outcome == OUTCOME_TIMEOUT)
+					++windows[i].timeouts;
+			}
+
+			++window;
+
+		next:
+			atomic_store_explicit(&ring->tail, ++tail,
+				memory_order_release);
+
+			if (config->every > 0 && window >= config->every)
+				break;
+		}
+
+		now = monotonic_ns();
+		expired = expired || worker_expired(worker);
+		finished = expired || (done && tail == head);
+		if ((config->every > 0 && window >= config->every)
+			|| (interval > 0 && now - last >= interval)
+			|| (finished && window > 0)) {
+			stream_emit(config, (now - start) / 1e9, results,
+				windows, worker->modules);
+			window = 0;
+			last = now;
+		}
+
+		if (finished)
+			break;
+
+		if (tail == head)
+			stream_sleep();
+	}
+
+	if (invalid > 0)
+		fprintf(stderr, "skipped %zu invalid puzzles\n", invalid);
+
+	return expired ? 0 : ring->status;
+}
+
+int stream_run(const struct config* config, int fd, char* const* filenames,
+	size_t modules)
+{
+	int status, i;
+	pthread_t reader;
+	struct ring* ring;
+	struct result* results;
+	struct window* windows;
+	struct worker worker;
+	struct corpus view;
+	struct watchdog watchdog;
+
+	ring = aligned_alloc(CACHE_LINE_SIZE, sizeof(*ring));
+	results = aligned_alloc(CACHE_LINE_SIZE, sizeof(*results) * modules);
+	windows = calloc(modules, sizeof(*windows));
+	memset(&worker, 0, sizeof(worker));
+	worker.repeats = calloc(config->repeat, sizeof(uint64_t));
+	if (config->max_incorrect > 0)
+		worker.strikes = calloc(modules, sizeof(*worker.strikes));
+	if (!ring || !results || !windows || !worker.repeats
+		|| (config->max_incorrect > 0 && !worker.strikes)) {
+		fputs("failed to allocate stream\n", stderr);
+		return -ENOMEM;
+	}
+
+	memset(results, 0, sizeof(*results) * modules);
+	dlerror();
+	for (i = 0; i < modules; ++i) {
+		status = module_init(&results[i].module, filenames[i]);
+		if (status < 0) {
+			fprintf(stderr,
+				"failed to load module: %s\n", filenames[i]);
+			return status;
+		}
+
+		histogram_reset(&windows[i].histogram);
+	}
+
+	memset(ring, 0, offsetof(struct ring, grids));
+	ring->fd = fd;
+
+	view.puzzles = ring->grids;
+	view.len = view.cap = STREAM_SLOTS;
+	worker.config = config;
+	worker.corpus = &view;
+	worker.results = results;
+	worker.modules = modules;
+
+	if (config->timeout > 0) {
+		status = watchdog_start(&watchdog, config->timeout, 1);
+		if (status < 0)
+			return status;
+
+		worker.watch = &watchdog.watches[0];
+		watch_enter(worker.watch);
+	}
+
+	printf("time,name,author,success,fail,incorrect,timeout,average,"
+		"median,min,max,p90,p99,throughput\n");
+
+	status = pthread_create(&reader, NULL, ring_reader, ring);
+	if (status != 0) {
+		fputs("failed to start reader\n", stderr);
+		return -status;
+	}
+
+	// the reader is cancelled in case the consumer stopped early, and is
+	// waiting on the input or a full ring
+	status = stream_consume(config, ring, &worker, windows);
+	pthread_cancel(reader);
+	pthread_join(reader, NULL);
+	if (config->timeout > 0)
+		watchdog_stop(&watchdog);
+
+	// nothing reads the modules' names or solvers once the reader and
+	// watchdog are gone
+	for (i = 0; i < modules; ++i)
+		dlclose(results[i].module.handle);
+
+	free(worker.repeats);
+	free(worker.strikes);
+	free(windows);
+	free(results);
+	free(ring);
+	return status;
+}
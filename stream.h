@@ -0,0 +1,27 @@
+// Sudoku Master Streaming
+//
+// Author: Matthew Knight
+// File Name: stream.h
+// Date: 2026-10-14
+//
+// In streaming mode puzzles are tested as they arrive rather than after the
+// whole input has been loaded, so the input never has to end. A reader thread
+// parses stdin into a fixed ring of grids, and every module is tested against
+// each puzzle on the calling thread as soon as it's published. Statistics are
+// kept in histograms and emitted, then reset, every so many puzzles or
+// milliseconds, so memory use doesn't grow with the length of the stream.
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stddef.h>
+
+#include "runner.h"
+
+#define STREAM_SLOTS 4096
+#define DEFAULT_STREAM_INTERVAL 1000
+
+int stream_run(const struct config* config, int fd, char* const* filenames,
+	size_t modules);
+
+#endif
@@ -0,0 +1,20 @@
+// Sudoku Master Common Definitions
+//
+// Author: Matthew Knight
+// File Name: sudoku.h
+// Date: 2026-10-14
+//
+// Constants shared between the harness translation units.
+
+#ifndef SUDOKU_H
+#define SUDOKU_H
+
+#define SUDOKU_SIZE 81
+#define SUDOKU_AXIS_SIZE 9
+
+#define CACHE_LINE_SIZE 64
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof(arr[0]))
+#define ALIGN_UP(n, align) (((n) + (align) - 1) & ~((size_t)(align) - 1))
+
+#endif
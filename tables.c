@@ -0,0 +1,69 @@
+// Sudoku Master Index Tables
+//
+// Author: Matthew Knight
+// File Name: tables.c
+// Date: 2026-10-14
+
+#include "tables.h"
+
+#define ROW(r) { \
+	(9 * (r)) + 0, (9 * (r)) + 1, (9 * (r)) + 2, \
+	(9 * (r)) + 3, (9 * (r)) + 4, (9 * (r)) + 5, \
+	(9 * (r)) + 6, (9 * (r)) + 7, (9 * (r)) + 8 }
+
+#define COL(c) { \
+	(c) + 0, (c) + 9, (c) + 18, \
+	(c) + 27, (c) + 36, (c) + 45, \
+	(c) + 54, (c) + 63, (c) + 72 }
+
+#define BOX_ORIGIN(b) ((((b) / 3) * 27) + (((b) % 3) * 3))
+
+#define BOX(b) { \
+	BOX_ORIGIN(b) + 0, BOX_ORIGIN(b) + 1, BOX_ORIGIN(b) + 2, \
+	BOX_ORIGIN(b) + 9, BOX_ORIGIN(b) + 10, BOX_ORIGIN(b) + 11, \
+	BOX_ORIGIN(b) + 18, BOX_ORIGIN(b) + 19, BOX_ORIGIN(b) + 20 }
+
+#define CELL(i) { (i) / 9, (i) % 9, (((i) / 27) * 3) + (((i) % 9) / 3) }
+
+#define CELLS(r) \
+	CELL((9 * (r)) + 0), CELL((9 * (r)) + 1), CELL((9 * (r)) + 2), \
+	CELL((9 * (r)) + 3), CELL((9 * (r)) + 4), CELL((9 * (r)) + 5), \
+	CELL((9 * (r)) + 6), CELL((9 * (r)) + 7), CELL((9 * (r)) + 8)
+
+// the row and column peers skip the cell itself, and the box peers are the
+// four cells of the box in neither its row nor its column
+#define SKIP(k, x) ((k) + ((k) >= (x)))
+#define OTHER(x, k) ((((x) / 3) * 3) + ((((x) % 3) + (k)) % 3))
+
+#define PEERS_AT(r, c) { \
+	(9 * (r)) + SKIP(0, c), (9 * (r)) + SKIP(1, c), \
+	(9 * (r)) + SKIP(2, c), (9 * (r)) + SKIP(3, c), \
+	(9 * (r)) + SKIP(4, c), (9 * (r)) + SKIP(5, c), \
+	(9 * (r)) + SKIP(6, c), (9 * (r)) + SKIP(7, c), \
+	(9 * SKIP(0, r)) + (c), (9 * SKIP(1, r)) + (c), \
+	(9 * SKIP(2, r)) + (c), (9 * SKIP(3, r)) + (c), \
+	(9 * SKIP(4, r)) + (c), (9 * SKIP(5, r)) + (c), \
+	(9 * SKIP(6, r)) + (c), (9 * SKIP(7, r)) + (c), \
+	(9 * OTHER(r, 1)) + OTHER(c, 1), (9 * OTHER(r, 1)) + OTHER(c, 2), \
+	(9 * OTHER(r, 2)) + OTHER(c, 1), (9 * OTHER(r, 2)) + OTHER(c, 2) }
+
+#define PEERS(r) \
+	PEERS_AT(r, 0), PEERS_AT(r, 1), PEERS_AT(r, 2), PEERS_AT(r, 3), \
+	PEERS_AT(r, 4), PEERS_AT(r, 5), PEERS_AT(r, 6), PEERS_AT(r, 7), \
+	PEERS_AT(r, 8)
+
+const uint8_t units[SUDOKU_UNITS][SUDOKU_AXIS_SIZE] = {
+	ROW(0), ROW(1), ROW(2), ROW(3), ROW(4), ROW(5), ROW(6), ROW(7), ROW(8),
+	COL(0), COL(1), COL(2), COL(3), COL(4), COL(5), COL(6), COL(7), COL(8),
+	BOX(0), BOX(1), BOX(2), BOX(3), BOX(4), BOX(5), BOX(6), BOX(7), BOX(8),
+};
+
+const struct cell_units cell_units[SUDOKU_SIZE] = {
+	CELLS(0), CELLS(1), CELLS(2), CELLS(3), CELLS(4), CELLS(5), CELLS(6),
+	CELLS(7), CELLS(8),
+};
+
+const uint8_t peers[SUDOKU_SIZE][SUDOKU_PEERS] = {
+	PEERS(0), PEERS(1), PEERS(2), PEERS(3), PEERS(4), PEERS(5), PEERS(6),
+	PEERS(7), PEERS(8),
+};
@@ -0,0 +1,33 @@
+// Sudoku Master Index Tables
+//
+// Author: Matthew Knight
+// File Name: tables.h
+// Date: 2026-10-14
+//
+// The layout of the grid, written out once as constant tables so that code
+// walking it never divides a cell index: the cells of each of the 27 rows,
+// columns and boxes, the row, column and box each cell belongs to, and the 20
+// peers of each cell that share one of them. They are built by macros from
+// the layout, so they live in read only data and cost nothing at startup.
+
+#ifndef TABLES_H
+#define TABLES_H
+
+#include <stdint.h>
+
+#include "sudoku.h"
+
+#define SUDOKU_UNITS 27
+#define SUDOKU_PEERS 20
+
+struct cell_units {
+    uint8_t row;
+    uint8_t col;
+    uint8_t box;
+};
+
+extern const uint8_t units[SUDOKU_UNITS][SUDOKU_AXIS_SIZE];
+extern const struct cell_units cell_units[SUDOKU_SIZE];
+extern const uint8_t peers[SUDOKU_SIZE][SUDOKU_PEERS];
+
+#endif
@@ -10,15 +10,18 @@ const char* name = "Test Module";
 
 const char* author = "Matthew Knight";
 
+// built with -DNULL_SOLVER it returns straight away, which is what the self
+// benchmark times as the floor under every sample
+#ifdef NULL_SOLVER
+int solve(int* puzzle)
+{
+	return 0;
+}
+#else
 int solve(int *puzzle) {
 	int i;
 	for (i = 0; i < 10000000; ++i)
 		;
 	return 0;
 }
-/*
-int solve(int* puzzle)
-{
-	return 0;
-}
-*/
+#endif
@@ -0,0 +1,133 @@
+// Sudoku Master Timing
+//
+// Author: Matthew Knight
+// File Name: timing.c
+// Date: 2026-10-14
+//
+// Clock sources are looked up by name, then calibrated: the tsc is measured
+// against CLOCK_MONOTONIC_RAW to find its frequency, and every source has the
+// cost of a back to back pair of reads measured so it can be subtracted from
+// each sample.
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "sudoku.h"
+#include "timing.h"
+
+#define CLOCK_OVERHEAD_ROUNDS 10000
+#define CLOCK_CALIBRATION_NS 50000000
+
+static const struct {
+	const char* name;
+	clockid_t id;
+	bool tsc;
+} sources[] = {
+	{ "process", CLOCK_PROCESS_CPUTIME_ID, false },
+	{ "thread", CLOCK_THREAD_CPUTIME_ID, false },
+	{ "monotonic-raw", CLOCK_MONOTONIC_RAW, false },
+	{ "tsc", CLOCK_MONOTONIC_RAW, true },
+};
+
+#ifdef HAVE_TSC
+static double tsc_calibrate(void)
+{
+	struct timespec now;
+	uint64_t start_ns, finish_ns, start_ticks, finish_ticks;
+	unsigned aux;
+
+	clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+	start_ns = ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+	start_ticks = __rdtscp(&aux);
+
+	do {
+		clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+		finish_ns = ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+	} while (finish_ns - start_ns < CLOCK_CALIBRATION_NS);
+
+	finish_ticks = __rdtscp(&aux);
+
+	return (double)(finish_ns - start_ns) / (finish_ticks - start_ticks);
+}
+#endif
+
+// the smallest interval between two consecutive reads is what every sample
+// pays for the clock itself
+static uint64_t clock_overhead(const struct clock_source* clock)
+{
+	int i;
+	uint64_t start, finish, overhead = UINT64_MAX;
+
+	for (i = 0; i < CLOCK_OVERHEAD_ROUNDS; ++i) {
+		start = clock_read(clock);
+		finish = clock_read(clock);
+		if (finish - start < overhead)
+			overhead = finish - start;
+	}
+
+	return overhead;
+}
+
+int clock_source_init(struct clock_source* clock, const char* name)
+{
+	int i;
+	struct timespec res;
+
+	memset(clock, 0, sizeof(*clock));
+
+	for (i = 0; i < ARRAY_SIZE(sources); ++i)
+		if (strcmp(sources[i].name, name) == 0)
+			break;
+
+	if (i == ARRAY_SIZE(sources)) {
+		fprintf(stderr, "unknown clock: %s\n", name);
+		return -EINVAL;
+	}
+
+	clock->name = sources[i].name;
+	clock->id = sources[i].id;
+	clock->tsc = sources[i].tsc;
+	clock->ns_per_tick = 1.0;
+
+	if (clock->tsc) {
+#ifdef HAVE_TSC
+		clock->ns_per_tick = tsc_calibrate();
+#else
+		fputs("tsc clock is not supported on this architecture\n",
+			stderr);
+		return -ENOTSUP;
+#endif
+	} else if (clock_getres(clock->id, &res) < 0) {
+		fprintf(stderr, "clock not available: %s\n", name);
+		return -errno;
+	}
+
+	clock->overhead = clock_overhead(clock);
+	return 0;
+}
+
+uint64_t clock_to_ns(const struct clock_source* clock, uint64_t ticks)
+{
+	if (!clock->tsc)
+		return ticks;
+
+	return (uint64_t)((ticks * clock->ns_per_tick) + 0.5);
+}
+
+// for statistics that aren't a whole number of ticks
+double clock_to_ns_f(const struct clock_source* clock, double ticks)
+{
+	return clock->tsc ? ticks * clock->ns_per_tick : ticks;
+}
+
+// the tsc's frequency, measured again unless it's the clock in use, or 0 where
+// there is no tsc
+double clock_tsc_ghz(const struct clock_source* clock)
+{
+#ifdef HAVE_TSC
+	return 1.0 / (clock->tsc ? clock->ns_per_tick : tsc_calibrate());
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,74 @@
+// Sudoku Master Timing
+//
+// Author: Matthew Knight
+// File Name: timing.h
+// Date: 2026-10-14
+//
+// Solves are timed against a selectable clock source. Samples are kept in the
+// clock's native ticks, which are nanoseconds for the clock_gettime sources
+// and cycles for the tsc, with the cost of reading the clock already taken
+// out. They are only converted to nanoseconds when statistics are printed.
+
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+struct clock_source {
+    const char* name;
+    clockid_t id;
+    bool tsc;
+    double ns_per_tick;
+    uint64_t overhead;
+};
+
+int clock_source_init(struct clock_source* clock, const char* name);
+uint64_t clock_to_ns(const struct clock_source* clock, uint64_t ticks);
+double clock_to_ns_f(const struct clock_source* clock, double ticks);
+double clock_tsc_ghz(const struct clock_source* clock);
+
+// rdtscp waits for every earlier instruction to retire, and the lfence keeps
+// later ones from starting before the counter is read
+static inline uint64_t clock_read(const struct clock_source* clock)
+{
+	struct timespec now;
+
+#ifdef HAVE_TSC
+	if (clock->tsc) {
+		unsigned aux;
+		uint64_t ticks = __rdtscp(&aux);
+
+		_mm_lfence();
+		return ticks;
+	}
+#endif
+
+	clock_gettime(clock->id, &now);
+	return ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+static inline uint64_t clock_elapsed(const struct clock_source* clock,
+	uint64_t start, uint64_t finish)
+{
+	uint64_t elapsed = finish - start;
+
+	return elapsed > clock->overhead ? elapsed - clock->overhead : 0;
+}
+
+// wall time for deadlines and polling, never for samples
+static inline uint64_t monotonic_ns(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t)now.tv_sec * 1000000000) + now.tv_nsec;
+}
+
+#endif
@@ -0,0 +1,153 @@
+// Sudoku Master Watchdog
+//
+// Author: Matthew Knight
+// File Name: watchdog.c
+// Date: 2026-10-14
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "timing.h"
+#include "watchdog.h"
+
+#define WATCHDOG_SIGNAL SIGUSR1
+#define WATCHDOG_MIN_POLL_NS 10000
+#define WATCHDOG_MAX_POLL_NS 1000000
+
+static __thread struct watch* watched;
+
+// a signal that arrives after the solve it was meant for has returned finds a
+// different sequence, and is ignored. the handler runs with the signal
+// unblocked so that jumping out of it leaves the mask as it was
+static void watchdog_signal(int sig)
+{
+	struct watch* watch = watched;
+	uint64_t sequence;
+
+	if (!watch)
+		return;
+
+	sequence = atomic_load_explicit(&watch->sequence,
+		memory_order_relaxed);
+	if ((sequence & 1) && atomic_load(&watch->fired) == sequence)
+		siglongjmp(watch->env, 1);
+}
+
+// a solve is timed from when the watchdog first sees it, so it's interrupted
+// somewhere between one and two polls after its budget runs out
+static void* watchdog_run(void* arg)
+{
+	size_t i;
+	uint64_t now, sequence, budget;
+	struct watch* watch;
+	struct watchdog* watchdog = arg;
+	uint64_t poll = watchdog->timeout / 8;
+	struct timespec req = { 0 };
+
+	if (poll < WATCHDOG_MIN_POLL_NS)
+		poll = WATCHDOG_MIN_POLL_NS;
+	else if (poll > WATCHDOG_MAX_POLL_NS)
+		poll = WATCHDOG_MAX_POLL_NS;
+
+	req.tv_nsec = poll;
+	while (!atomic_load(&watchdog->stop)) {
+		now = monotonic_ns();
+		for (i = 0; i < watchdog->len; ++i) {
+			watch = &watchdog->watches[i];
+			sequence = atomic_load_explicit(&watch->sequence,
+				memory_order_acquire);
+			if (!(sequence & 1))
+				continue;
+
+			if (sequence != watchdog->seen[i]) {
+				watchdog->seen[i] = sequence;
+				watchdog->since[i] = now;
+				continue;
+			}
+
+			budget = watchdog->timeout
+				* atomic_load_explicit(&watch->solves,
+					memory_order_relaxed);
+			if (now - watchdog->since[i] > budget
+				&& atomic_load(&watch->fired) != sequence) {
+				atomic_store(&watch->fired, sequence);
+				pthread_kill(watch->thread, WATCHDOG_SIGNAL);
+			}
+		}
+
+		nanosleep(&req, NULL);
+	}
+
+	return NULL;
+}
+
+// len watches are handed out, one for each thread that's going to solve
+int watchdog_start(struct watchdog* watchdog, uint64_t timeout, size_t len)
+{
+	int status, policy;
+	struct sigaction action;
+	struct sched_param param;
+
+	memset(watchdog, 0, sizeof(*watchdog));
+	watchdog->timeout = timeout;
+	watchdog->len = len;
+	watchdog->watches = aligned_alloc(CACHE_LINE_SIZE,
+		sizeof(struct watch) * len);
+	watchdog->seen = calloc(len, sizeof(uint64_t));
+	watchdog->since = calloc(len, sizeof(uint64_t));
+	if (!watchdog->watches || !watchdog->seen || !watchdog->since) {
+		fputs("failed to allocate watchdog\n", stderr);
+		return -ENOMEM;
+	}
+
+	memset(watchdog->watches, 0, sizeof(struct watch) * len);
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = watchdog_signal;
+	action.sa_flags = SA_NODEFER;
+	sigemptyset(&action.sa_mask);
+	if (sigaction(WATCHDOG_SIGNAL, &action, NULL) < 0) {
+		fputs("failed to install watchdog handler\n", stderr);
+		return -errno;
+	}
+
+	status = pthread_create(&watchdog->thread, NULL, watchdog_run,
+		watchdog);
+	if (status != 0) {
+		fputs("failed to start watchdog\n", stderr);
+		return -status;
+	}
+
+	// under SCHED_FIFO a hung solve would never give up the cpu to a
+	// watchdog of the same priority
+	if (pthread_getschedparam(pthread_self(), &policy, &param) == 0
+		&& policy == SCHED_FIFO) {
+		++param.sched_priority;
+		pthread_setschedparam(watchdog->thread, SCHED_FIFO, &param);
+	}
+
+	return 0;
+}
+
+void watchdog_stop(struct watchdog* watchdog)
+{
+	atomic_store(&watchdog->stop, true);
+	pthread_join(watchdog->thread, NULL);
+
+	free(watchdog->watches);
+	free(watchdog->seen);
+	free(watchdog->since);
+}
+
+// must be called by the thread that owns the watch, before it's armed
+void watch_enter(struct watch* watch)
+{
+	watch->thread = pthread_self();
+	watched = watch;
+}
@@ -0,0 +1,71 @@
+// Sudoku Master Watchdog
+//
+// Author: Matthew Knight
+// File Name: watchdog.h
+// Date: 2026-10-14
+//
+// A solve running in the harness's own process can't be killed, so it's
+// interrupted instead. Every thread that solves under a timeout owns a watch,
+// and bumps its sequence to an odd number for the length of each call into a
+// module, which costs two stores and no clock reads. The watchdog thread looks
+// at every watch a few times per timeout, and when a watch has shown the same
+// odd sequence for longer than its call's budget it signals the thread, whose
+// handler jumps out of the module and back into the harness. A module that's
+// interrupted can be left holding locks or half updated state, so --isolate is
+// still the way to test modules that are expected to hang.
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sudoku.h"
+
+struct watch {
+    _Atomic uint64_t sequence;
+    _Atomic uint64_t fired;
+    _Atomic size_t solves;
+    pthread_t thread;
+    sigjmp_buf env;
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+struct watchdog {
+    pthread_t thread;
+    _Atomic bool stop;
+    uint64_t timeout;
+    struct watch* watches;
+    uint64_t* seen;
+    uint64_t* since;
+    size_t len;
+};
+
+int watchdog_start(struct watchdog* watchdog, uint64_t timeout, size_t len);
+void watchdog_stop(struct watchdog* watchdog);
+void watch_enter(struct watch* watch);
+
+// the call that follows is given a budget of a timeout per puzzle
+static inline void watch_arm(struct watch* watch, size_t solves)
+{
+	uint64_t sequence = atomic_load_explicit(&watch->sequence,
+		memory_order_relaxed);
+
+	atomic_store_explicit(&watch->solves, solves, memory_order_relaxed);
+	atomic_store_explicit(&watch->sequence, sequence + 1,
+		memory_order_release);
+}
+
+static inline void watch_disarm(struct watch* watch)
+{
+	uint64_t sequence = atomic_load_explicit(&watch->sequence,
+		memory_order_relaxed);
+
+	atomic_store_explicit(&watch->sequence, sequence + 1,
+		memory_order_relaxed);
+}
+
+#endif